@@ -0,0 +1,47 @@
+/*
+  checkpoint/WorldCheckpoint.h
+    SaveCheckpoint / LoadCheckpoint write a Pt1 world (update count, random number generator
+    and everything its PopulationManager_ABPhysics holds) to a checkpoint file and read
+    it back.
+
+    LoadCheckpoint expects a freshly built world (population manager Setup, but not yet
+    configured or populated); the world's settings come from the checkpoint.
+
+    Physics draws from the world's random number generator, and every body (with its links,
+    in order) is restored exactly, so a resumed run carries on just as it would have.
+*/
+
+#ifndef WORLD_CHECKPOINT_H
+#define WORLD_CHECKPOINT_H
+
+#include <string>
+
+#include "../../shared/checkpoint/CheckpointFile.h"
+
+// Bump whenever the payload layout changes.
+constexpr uint32_t PT1_CHECKPOINT_VERSION = 1;
+
+template <typename WORLD>
+bool SaveCheckpoint(WORLD &world, const std::string &filename) {
+  ByteWriter writer;
+  writer.Write((int) world.update);
+  WriteRandom(writer, world.GetRandom());
+  world.popM.SaveState(writer);
+  return WriteCheckpointFile(filename, CHECKPOINT_KIND::PT1, PT1_CHECKPOINT_VERSION, writer.GetBuffer());
+}
+
+template <typename WORLD>
+bool LoadCheckpoint(WORLD &world, const std::string &filename) {
+  MappedCheckpoint checkpoint(filename, CHECKPOINT_KIND::PT1, PT1_CHECKPOINT_VERSION);
+  if (!checkpoint.IsOK()) return false;
+  ByteReader reader = checkpoint.GetReader();
+  const int update = reader.Read<int>();
+  if (!ReadRandom(reader, world.GetRandom()) || !world.popM.LoadState(reader) || !reader.AtEnd()) {
+    std::cerr << "Could not load checkpoint " << filename << ": payload does not match this version" << std::endl;
+    return false;
+  }
+  world.update = update;
+  return true;
+}
+
+#endif
@@ -6,10 +6,15 @@
      - A nutrient pull: sum(0) in genome
      - B nutrient pull: sum(1) in genome
     * Replicate after collecting 10 nutrients
+    * Usage: evo_in_physics_pt1 [checkpoint_file]
+     - If checkpoint_file exists, pick up from it (and run UPDATES more updates); the
+       world is saved there when the run ends.
   Basically, me learning to use Evoke code.
 */
 
 #include <iostream>
+#include <fstream>
+#include <string>
 
 #include "tools/Random.h"
 
@@ -18,6 +23,7 @@
 #include "organisms/ABPhysicsOrganism.h"
 #include "nutrients/ABPhysicsNutrient.h"
 #include "population_managers/PopulationManager_ABPhysics.h"
+#include "checkpoint/WorldCheckpoint.h"
 
 ///////////////////////////////
 // Developer notes:
@@ -32,7 +38,7 @@
 // ISSUES
 //  * EMP_TRACK_MEMORY on bodies kills program
 
-int main() {
+int main(int argc, char *argv[]) {
   // Initialize the random number generator
   emp::Random random;
   // Evolution parameters
@@ -46,18 +52,25 @@ int main() {
 
   // Build the world
   emp::evo::World<ABPhysicsOrganism, emp::evo::PopulationManager_ABPhysics<ABPhysicsOrganism>> world(random, "AB_Physics_World");
-  // Configure the population manager
-  world.ConfigPop(WORLD_WIDTH, WORLD_HEIGHT, MAX_ORG_DIAM, ORG_DETACH_ON_BIRTH);
-  // Build a population
-  for (int p = 0; p < 10; p++) {
-    emp::Point<double> org_loc(1, 1);
-    int org_radius = 1;
-    world.Insert(ABPhysicsOrganism(emp::Circle<double>(org_loc, org_radius), GENOME_LENGTH));
+  const std::string checkpoint_file = (argc > 1) ? argv[1] : "";
+  if (checkpoint_file != "" && std::ifstream(checkpoint_file)) {
+    // Pick up where a previous run left off.
+    if (!LoadCheckpoint(world, checkpoint_file)) return 1;
+  } else {
+    // Configure the population manager
+    world.ConfigPop(WORLD_WIDTH, WORLD_HEIGHT, MAX_ORG_DIAM, ORG_DETACH_ON_BIRTH);
+    // Build a population
+    for (int p = 0; p < 10; p++) {
+      emp::Point<double> org_loc(1, 1);
+      int org_radius = 1;
+      world.Insert(ABPhysicsOrganism(emp::Circle<double>(org_loc, org_radius), GENOME_LENGTH));
+    }
   }
   for (int u = 1; u <= UPDATES; u++) {
-    std::cout << "Current update: " << u << std::endl;
+    std::cout << "Current update: " << world.update + 1 << std::endl;
     world.Update();
   }
+  if (checkpoint_file != "" && !SaveCheckpoint(world, checkpoint_file)) return 1;
   std::cout << "DONE" << std::endl;
   return 0;
 }
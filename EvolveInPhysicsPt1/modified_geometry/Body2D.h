@@ -34,8 +34,14 @@
 #include <string>
 
 namespace emp {
+namespace evo {
+  template <typename ORG> class PopulationManager_ABPhysics;
+}
 
   class Body2D_Base {
+    // Saves and restores links (checkpoints), so it needs to name them.
+    template <typename ORG> friend class evo::PopulationManager_ABPhysics;
+
   protected:
     // Bodies can be linked in seveal ways.
     // DEFAULT -> Joined together with no extra meaning
@@ -90,11 +96,16 @@ namespace emp {
     int GetReproCount() const { return repro_count; }
     bool GetDetachOnRepro() const { return detach_on_repro; }
     Point<double> GetShift() const { return shift; }
+    const Point<double> & GetCumShift() const { return cum_shift; }
     double GetPressure() const { return pressure; }
 
     void SetBirthTime(double in_time) { birth_time = in_time; }
     void SetDetachOnRepro(bool detach) { detach_on_repro = detach; }
     void SetColorID(uint32_t in_id) { color_id = in_id; }
+    void SetReproCount(int count) { repro_count = count; }
+    // Restore state that normally only builds up during updates (e.g., from a checkpoint).
+    void SetCumShift(const Point<double> & s) { cum_shift = s; }
+    void SetPressure(double p) { pressure = p; }
 
     // Orientation control...
     void TurnLeft(int steps=1) { orientation.RotateDegrees(45); }
@@ -173,6 +184,14 @@ namespace emp {
     }
 
     int GetLinkCount() const { return (int) (from_links.size() + to_links.size()); }
+    const emp::vector< BodyLink<CircleBody2D> * > & GetFromLinks() const { return from_links; }
+    const emp::vector< BodyLink<CircleBody2D> * > & GetToLinks() const { return to_links; }
+
+    // Reorder the links targeting this body (order must hold exactly the same links).
+    void SetToLinkOrder(const emp::vector< BodyLink<CircleBody2D> * > & order) {
+      emp_assert(order.size() == to_links.size());
+      to_links = order;
+    }
 
     void AddLink(LINK_TYPE type, CircleBody2D & link_org, double cur_dist, double target_dist, double link_strength = 0) {
       emp_assert(!IsLinked(link_org));  // Don't link twice!
@@ -39,6 +39,7 @@ class ABPhysicsNutrient : public emp::CircleBody2D {
     void SetValue(double value) { this->value = value; }
     void SetType(int type) { this->type = type; }
     void Age(int inc = 1) { this->age += inc; }
+    void SetAge(int age) { this->age = age; }
 
     // If a body is not at its target radius, grow it or shrink it, as needed.
     void BodyUpdate(double change_factor=1, bool detach_on_birth=true) {
@@ -79,6 +79,9 @@ class ABPhysicsOrganism : public emp::CircleBody2D {
     }
 
     void SetPopPressureThreshold(double thresh) { pop_pressure_threshold = thresh; }
+    void SetEnergy(double e) { energy = e; }
+    void SetNumResourcesCollected(int count) { resources_collected = count; }
+    void SetOffspringCount(int count) { offspring_count = count; }
 
     ABPhysicsOrganism * Reproduce(emp::Point<double> offset, emp::Random *r, double cost = 0.0, double mut_rate = 0.0) {
       /* Handles organism reproduction!
@@ -9,6 +9,8 @@
 
 #include <iostream>
 #include <functional>
+#include <unordered_map>
+#include <algorithm>
 
 #include "../modified_geometry/ABPhysics2D.h"
 #include "../modified_geometry/Surface2D.h"
@@ -16,6 +18,7 @@
 #include "../modified_geometry/Body2D.h"
 
 #include "../nutrients/ABPhysicsNutrient.h"
+#include "../../shared/checkpoint/CheckpointFile.h"
 
 #include "evo/PopulationManager.h"
 #include "tools/vector.h"
@@ -61,6 +64,39 @@ class PopulationManager_ABPhysics {
     int best_ones;
     int best_zeros;
 
+    using Link_t = CircleBody2D::BodyLink<CircleBody2D>;
+
+    // Everything about a body that carries over from one update to the next. (Orientation is
+    // left out: nothing here turns bodies. The shift and total_abs_shift accumulators are
+    // always empty between updates.)
+    static void SaveBody(ByteWriter &writer, const CircleBody2D &body) {
+      writer.Write(body.GetCenter().GetX()).Write(body.GetCenter().GetY());
+      writer.Write(body.GetRadius()).Write(body.GetTargetRadius()).Write(body.GetBirthTime());
+      writer.Write(body.GetVelocity().GetX()).Write(body.GetVelocity().GetY()).Write(body.GetMass());
+      writer.Write(body.GetColorID()).Write(body.GetReproCount()).Write(body.GetDetachOnRepro());
+      writer.Write(body.GetCumShift().GetX()).Write(body.GetCumShift().GetY()).Write(body.GetPressure());
+    }
+
+    static void LoadBody(ByteReader &reader, CircleBody2D &body) {
+      const double x = reader.Read<double>();
+      const double y = reader.Read<double>();
+      body.SetPosition(Point<double>(x, y));
+      body.SetRadius(reader.Read<double>());
+      body.SetTargetRadius(reader.Read<double>());
+      body.SetBirthTime(reader.Read<double>());
+      const double vx = reader.Read<double>();
+      const double vy = reader.Read<double>();
+      body.SetVelocity(vx, vy);
+      body.SetMass(reader.Read<double>());
+      body.SetColorID(reader.Read<uint32_t>());
+      body.SetReproCount(reader.Read<int>());
+      body.SetDetachOnRepro(reader.Read<bool>());
+      const double shift_x = reader.Read<double>();
+      const double shift_y = reader.Read<double>();
+      body.SetCumShift(Point<double>(shift_x, shift_y));
+      body.SetPressure(reader.Read<double>());
+    }
+
   public:
     PopulationManager_ABPhysics()
       : physics(),
@@ -124,6 +160,119 @@ class PopulationManager_ABPhysics {
 
     ABPhysics2D<ORG, RESOURCE> & GetPhysics() { return physics; }
 
+    void SaveState(ByteWriter &writer) {
+      /*
+        Write everything needed to carry on from this point: parameters, every organism and
+        resource (in order) and every link between them (in order on both ends, since physics
+        and feeding walk links in order). Call between updates.
+      */
+      writer.Write(physics.GetWidth()).Write(physics.GetHeight()).Write(physics.GetDetach());
+      writer.Write(max_pop_size).Write(point_mutation_rate).Write(max_org_radius);
+      writer.Write(max_resource_age).Write(max_resource_count).Write(cost_of_reproduction);
+      writer.Write(resource_energy_content).Write(drift).Write(best_ones).Write(best_zeros);
+      // Bodies are numbered organisms first, then resources (links refer to them by number).
+      std::unordered_map<const CircleBody2D *, int> body_ids;
+      emp::vector<const CircleBody2D *> bodies;
+      writer.Write(GetSize());
+      for (auto *org : physics.GetOrgBodySet()) {
+        SaveBody(writer, *org);
+        writer.Write(org->genome);
+        writer.Write(org->GetEnergy()).Write(org->GetNumResourcesCollected()).Write(org->GetOffspringCount());
+        writer.Write(org->GetPopPressureThreshold());
+        body_ids[org] = (int) bodies.size();
+        bodies.push_back(org);
+      }
+      writer.Write(GetNumResources());
+      for (auto *res : physics.GetResourceBodySet()) {
+        SaveBody(writer, *res);
+        writer.Write(res->GetType()).Write(res->GetValue()).Write(res->GetAge());
+        body_ids[res] = (int) bodies.size();
+        bodies.push_back(res);
+      }
+      // Links in the order their initiators hold them, each with its place in its target's list.
+      int num_links = 0;
+      for (auto *body : bodies) num_links += (int) body->GetFromLinks().size();
+      writer.Write(num_links);
+      for (int from_id = 0; from_id < (int) bodies.size(); from_id++) {
+        for (auto *link : bodies[from_id]->GetFromLinks()) {
+          const auto &target_links = link->to->GetToLinks();
+          const int to_pos = (int) (std::find(target_links.begin(), target_links.end(), link) - target_links.begin());
+          writer.Write(from_id).Write(body_ids.at(link->to)).Write(to_pos).Write((int) link->type);
+          writer.Write(link->cur_dist).Write(link->target_dist).Write(link->link_strength);
+        }
+      }
+    }
+
+    bool LoadState(ByteReader &reader) {
+      /*
+        Rebuild the state written by SaveState. Only call on a population manager that has
+        been Setup but not yet configured or populated.
+      */
+      const double width = reader.Read<double>();
+      const double height = reader.Read<double>();
+      const bool detach = reader.Read<bool>();
+      const int pop_size = reader.Read<int>();
+      const double mutation_rate = reader.Read<double>();
+      const double org_radius = reader.Read<double>();
+      const int resource_age = reader.Read<int>();
+      const int resource_count = reader.Read<int>();
+      const double repro_cost = reader.Read<double>();
+      const double energy_content = reader.Read<double>();
+      if (!reader.IsOK()) return false;
+      ConfigPop(width, height, pop_size, org_radius, detach, mutation_rate, repro_cost, resource_count,
+                resource_age, energy_content);
+      drift = reader.Read<double>();
+      best_ones = reader.Read<int>();
+      best_zeros = reader.Read<int>();
+      emp::vector<CircleBody2D *> bodies;
+      const int num_orgs = reader.Read<int>();
+      for (int i = 0; i < num_orgs && reader.IsOK(); i++) {
+        auto *org = new ORG(emp::Circle<double>(Point<double>(0, 0), 1));
+        LoadBody(reader, *org);
+        reader.Read(org->genome);
+        org->SetEnergy(reader.Read<double>());
+        org->SetNumResourcesCollected(reader.Read<int>());
+        org->SetOffspringCount(reader.Read<int>());
+        org->SetPopPressureThreshold(reader.Read<double>());
+        AddOrg(org);
+        bodies.push_back(org);
+      }
+      const int num_resources = reader.Read<int>();
+      for (int i = 0; i < num_resources && reader.IsOK(); i++) {
+        auto *res = new RESOURCE(emp::Circle<double>(Point<double>(0, 0), 1));
+        LoadBody(reader, *res);
+        res->SetType(reader.Read<int>());
+        res->SetValue(reader.Read<double>());
+        res->SetAge(reader.Read<int>());
+        AddResource(res);
+        bodies.push_back(res);
+      }
+      // Re-link (which restores the initiators' order), then put every target's list back in order.
+      std::unordered_map<Link_t *, int> to_positions;
+      const int num_links = reader.Read<int>();
+      for (int i = 0; i < num_links && reader.IsOK(); i++) {
+        const int from_id = reader.Read<int>();
+        const int to_id = reader.Read<int>();
+        const int to_pos = reader.Read<int>();
+        const auto type = (CircleBody2D::LINK_TYPE) reader.Read<int>();
+        const double cur_dist = reader.Read<double>();
+        const double target_dist = reader.Read<double>();
+        const double link_strength = reader.Read<double>();
+        if (!reader.IsOK() || from_id < 0 || to_id < 0 || from_id >= (int) bodies.size()
+            || to_id >= (int) bodies.size() || bodies[from_id]->IsLinked(*bodies[to_id])) return false;
+        bodies[from_id]->AddLink(type, *bodies[to_id], cur_dist, target_dist, link_strength);
+        to_positions[bodies[from_id]->GetFromLinks().back()] = to_pos;
+      }
+      for (auto *body : bodies) {
+        emp::vector<Link_t *> order(body->GetToLinks());
+        std::sort(order.begin(), order.end(), [&to_positions](Link_t *a, Link_t *b) {
+          return to_positions[a] < to_positions[b];
+        });
+        body->SetToLinkOrder(order);
+      }
+      return reader.IsOK();
+    }
+
     int AddOrg(ORG *new_org) {
       // Returns position in physics?
       int pos = this->GetSize();
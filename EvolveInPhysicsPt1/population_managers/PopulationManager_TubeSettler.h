@@ -52,6 +52,31 @@ class PopulationManager_TubeSettler {
     int best_ones;
     int best_zeros;
 
+    // Scratch space for Brownian motion.
+    vector<double> noise_uniforms;
+    vector<double> noise_x;
+    vector<double> noise_y;
+
+    // Give every body in bodies a kick of length magnitude in a random direction. All
+    // directions are drawn first, then turned into x/y kicks by table lookup
+    // (sin_chart_1K/cos_chart_1K: 256 directions, scaled by 1024), then applied; each stage
+    // is one pass over flat arrays instead of an Angle + trig per body.
+    template <typename BODY_SET>
+    void ApplyBrownianMotion(BODY_SET &bodies, double magnitude) {
+      const int count = (int) bodies.size();
+      noise_uniforms.resize(count);
+      noise_x.resize(count);
+      noise_y.resize(count);
+      for (int i = 0; i < count; i++) noise_uniforms[i] = random_ptr->GetDouble();
+      const double scale = magnitude / 1024.0;
+      for (int i = 0; i < count; i++) {
+        const int dir = ((int) (noise_uniforms[i] * 256.0)) & 255;
+        noise_x[i] = emp::sin_chart_1K[dir] * scale;
+        noise_y[i] = emp::cos_chart_1K[dir] * scale;
+      }
+      for (int i = 0; i < count; i++) bodies[i]->IncSpeed(emp::Point<double>(noise_x[i], noise_y[i]));
+    }
+
   public:
     PopulationManager_TubeSettler()
       : physics(),
@@ -145,8 +170,6 @@ class PopulationManager_TubeSettler {
         double terminal_velocity = 5.0;
         // Add (something analogous to) gravity
         if (use_gravity && (org->GetVelocity().GetY() < terminal_velocity)) org->IncSpeed(Angle(0.0).GetPoint(1.0));
-        //Add a small amount of Brownian motion
-        org->IncSpeed(Angle(random_ptr->GetDouble() * (2.0 * emp::PI)).GetPoint(drift));
 
         // Update organism color based on energy levels! (ALERT! MAGIC NUMBER HERE)
         int num_ones = org->genome.CountOnes();
@@ -169,6 +192,8 @@ class PopulationManager_TubeSettler {
           new_organisms.push_back(baby_org);  // Mark this baby org to be added to the world.
         }
       } // end population loop
+      //Add a small amount of Brownian motion
+      ApplyBrownianMotion(pop, drift);
       // Adding new bodies to world would happen here
       // Make room in population for new organisms.
       if ((int)(pop.size() + new_organisms.size()) > max_pop_size) {
@@ -186,9 +211,7 @@ class PopulationManager_TubeSettler {
 
       // Move the resources round (TODO: surface should define flow force matrix -- precalculated static forces for each location)
       // TODO: move resource removal here? -- Physics doesn't really need to handle that? Or keep in physics?
-      for (auto *res : resources) {
-        res->IncSpeed(Angle(random_ptr->GetDouble() * (2.0 * emp::PI)).GetPoint(drift * 0.5));  // Some brownian motion for resources
-      }
+      ApplyBrownianMotion(resources, drift * 0.5);  // Some brownian motion for resources
       // While there aren't enough resources in the environment, add more randomly
       while (GetNumResources() < max_resource_count) {
         emp::Point<double> res_center(random_ptr->GetDouble(10.0, physics.GetWidth() - 10.0), random_ptr->GetDouble(10.0, physics.GetHeight()));
@@ -0,0 +1,131 @@
+/*
+  evo_in_physics_pt2.cc
+
+  Headless native driver for the Pt2 experiment.
+    * Builds the same world as evo_in_physics_pt2_web.cc (one randomized ancestor in the
+      middle of the world), without drawing anything.
+    * Parameters come from evo-in-physics-pt2.cfg and/or the command line.
+    * Runs UPDATES updates as fast as possible and reports updates/sec and bodies/sec
+      (bodies = organisms + resources, summed over updates).
+    * If TRAJECTORY_FILE is set, every body's position is recorded there every
+      TRAJECTORY_INTERVAL updates (see recording/TrajectoryFile.h).
+*/
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <memory>
+
+#include "./organisms/SimpleOrganism.h"
+#include "./population-managers/PopulationManager_SimplePhysics.h"
+#include "./recording/TrajectoryFile.h"
+
+#include "config/ArgManager.h"
+#include "config/config.h"
+
+#include "tools/Random.h"
+
+#include "evo/World.h"
+
+EMP_BUILD_CONFIG(EvoInPhysicsPt2Config,
+  GROUP(DEFAULT, "Default settings for Evo In Physics Pt 2 experiments."),
+  VALUE(RANDOM_SEED, int, 1, "Random number seed (0 for based on time)."),
+  VALUE(WORLD_WIDTH, int, 500, "Width of the physics world."),
+  VALUE(WORLD_HEIGHT, int, 500, "Height of the physics world."),
+  VALUE(MAX_POP_SIZE, int, 250, "Maximum population size allowed in the world."),
+  VALUE(GENOME_LENGTH, int, 10, "Number of sites in each organism's genome."),
+  VALUE(POINT_MUTATION_RATE, double, 0.01, "Organism per-site mutation rate."),
+  VALUE(MAX_ORGANISM_RADIUS, double, 10, "Organism radius."),
+  VALUE(COST_OF_REPRO, double, 1, "How much energy is necessary for an organism to reproduce?"),
+  VALUE(DETACH_ON_BIRTH, bool, true, "Do organisms detach from parents at birth?"),
+  VALUE(ORGANISM_MEMBRANE_STRENGTH, double, 10.0, "How much pressure an organism can take before popping."),
+  VALUE(MAX_RESOURCE_AGE, int, 100, "Maximum number of updates that resources may persist."),
+  VALUE(MAX_RESOURCE_COUNT, int, 100, "Maximum number of resources allowed in the environment at any given time."),
+  VALUE(RESOURCE_RADIUS, double, 5.0, "Resource radius."),
+  VALUE(RESOURCE_VALUE, double, 1.0, "How much energy is each resource worth when consumed?"),
+  VALUE(SURFACE_FRICTION, double, 0.0025, "Surface friction."),
+  VALUE(MOVEMENT_NOISE, double, 0.15, "Magnitude of the random kick bodies get every update."),
+  GROUP(RUN, "Settings for headless runs."),
+  VALUE(UPDATES, int, 1000, "How many updates to run."),
+  VALUE(NUM_TILES, int, 1, "How many tiles to split the physics into (see geometry/TiledPhysics2D.h)."),
+  VALUE(NUM_THREADS, int, 1, "How many threads update the physics tiles."),
+  VALUE(REPORT_INTERVAL, int, 100, "Print population counts every this many updates (0 for never)."),
+  GROUP(TRAJECTORY, "Settings for recording body trajectories."),
+  VALUE(TRAJECTORY_FILE, std::string, "", "File to record body positions to (empty for none)."),
+  VALUE(TRAJECTORY_INTERVAL, int, 1, "Record a frame every this many updates."),
+  VALUE(TRAJECTORY_FORMAT, std::string, "float32", "How to store coordinates: float32, float16 or quantized.")
+)
+
+using Organism_t = SimpleOrganism;
+using SimplePhysicsWorld = emp::evo::World<Organism_t, emp::evo::PopulationManager_SimplePhysics<Organism_t> >;
+
+int main(int argc, char *argv[]) {
+  // Load config.
+  EvoInPhysicsPt2Config config;
+  std::string config_filename = "evo-in-physics-pt2.cfg";
+  config.Read(config_filename);
+  auto args = emp::cl::ArgManager(argc, argv);
+  if (!args.ProcessConfigOptions(config, std::cout, config_filename)) return 0;
+
+  // Build the world.
+  emp::Random random(config.RANDOM_SEED());
+  SimplePhysicsWorld world(random, "simple-world");
+  world.popM.GetPhysics().ConfigTiles(config.NUM_TILES(), config.NUM_THREADS());
+  world.ConfigPop(config.WORLD_WIDTH(), config.WORLD_HEIGHT(), config.SURFACE_FRICTION(),
+                  config.MAX_POP_SIZE(), config.POINT_MUTATION_RATE(), config.MAX_ORGANISM_RADIUS(),
+                  config.COST_OF_REPRO(), config.MAX_RESOURCE_AGE(), config.MAX_RESOURCE_COUNT(),
+                  config.RESOURCE_RADIUS(), config.RESOURCE_VALUE(), config.MOVEMENT_NOISE());
+
+  // Initialize the population with a single, randomized ancestor.
+  const emp::Point<double> mid_point(config.WORLD_WIDTH() / 2.0, config.WORLD_HEIGHT() / 2.0);
+  int org_radius = config.MAX_ORGANISM_RADIUS();
+  Organism_t ancestor(emp::Circle<double>(mid_point, org_radius), config.GENOME_LENGTH(), config.DETACH_ON_BIRTH());
+  for (int i = 0; i < ancestor.genome.GetSize(); i++) {
+    if (random.P(0.5)) ancestor.genome[i] = !ancestor.genome[i];
+  }
+  ancestor.GetBody().SetMass(10.0);
+  ancestor.SetMembraneStrength(config.ORGANISM_MEMBRANE_STRENGTH());
+  ancestor.SetBirthTime(-1);
+  world.Insert(ancestor);
+
+  // Record trajectories?
+  std::unique_ptr<TrajectoryWriter> trajectory;
+  if (config.TRAJECTORY_FILE() != "") {
+    TRAJECTORY_FORMAT format;
+    if (config.TRAJECTORY_FORMAT() == "float32") format = TRAJECTORY_FORMAT::FLOAT32;
+    else if (config.TRAJECTORY_FORMAT() == "float16") format = TRAJECTORY_FORMAT::FLOAT16;
+    else if (config.TRAJECTORY_FORMAT() == "quantized") format = TRAJECTORY_FORMAT::QUANTIZED;
+    else {
+      std::cerr << "Unknown TRAJECTORY_FORMAT: " << config.TRAJECTORY_FORMAT() << std::endl;
+      return 1;
+    }
+    trajectory.reset(new TrajectoryWriter(config.TRAJECTORY_FILE(), format, config.TRAJECTORY_INTERVAL(),
+                                          config.WORLD_WIDTH(), config.WORLD_HEIGHT()));
+    if (!trajectory->IsOK()) return 1;
+    trajectory->Attach<Organism_t, SimpleResource>(world.popM.GetPhysics());
+  }
+
+  // Run!
+  const int updates = config.UPDATES();
+  const int report_interval = config.REPORT_INTERVAL();
+  double body_updates = 0.0;
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int ud = 0; ud < updates; ud++) {
+    world.Update();
+    body_updates += world.popM.GetSize() + world.popM.GetNumResources();
+    if (report_interval > 0 && world.update % report_interval == 0) {
+      std::cout << "Update: " << world.update << " Organisms: " << world.popM.GetSize()
+                << " Resources: " << world.popM.GetNumResources() << "\n";
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  const double seconds = elapsed.count();
+  std::cout << "Ran " << updates << " updates in " << seconds << " seconds: "
+            << (seconds > 0.0 ? updates / seconds : 0.0) << " updates/sec, "
+            << (seconds > 0.0 ? body_updates / seconds : 0.0) << " bodies/sec" << std::endl;
+  if (trajectory) {
+    trajectory->Close();
+    std::cout << "Recorded " << trajectory->GetNumFrames() << " frames to " << config.TRAJECTORY_FILE() << std::endl;
+  }
+  return 0;
+}
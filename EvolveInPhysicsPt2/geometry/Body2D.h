@@ -227,6 +227,7 @@ namespace emp {
     }
 
     int GetLinkCount() const { return (int) (from_links.size() + to_links.size()); }
+    const emp::vector< BodyLink<CircleBody2D> * > & GetFromLinks() const { return from_links; }
 
     // Add link FROM this TO link_body.
     void AddLink(LINK_TYPE type, CircleBody2D & link_body, double cur_dist, double target_dist, double link_strength = 0) {
@@ -236,6 +237,8 @@ namespace emp {
       auto * new_link = new BodyLink<CircleBody2D>(type, this, &link_body, cur_dist, target_dist, link_strength);
       from_links.push_back(new_link);
       link_body.to_links.push_back(new_link);
+      // Gestating offspring (BodyUpdate counts this back down when the link reaches its target).
+      if (type == LINK_TYPE::REPRODUCTION) repro_count++;
     }
 
     void RemoveLink(BodyLink<CircleBody2D> * link) {
@@ -307,7 +310,6 @@ namespace emp {
       auto * offspring = new CircleBody2D(perimeter);
       AddLink(LINK_TYPE::REPRODUCTION, *offspring, offset.Magnitude(), perimeter.GetRadius()*2.0);
       offspring->Translate(offset);
-      repro_count++;
 
       return offspring;
     }
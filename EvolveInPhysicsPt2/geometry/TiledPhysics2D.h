@@ -0,0 +1,381 @@
+//  TiledPhysics2D - SimplePhysics2D split across worker threads by spatial tiles.
+//
+//  The world is cut into vertical stripes (tiles). Each update:
+//    * Every body is owned by the tile its center lies in. Ownership is recomputed from
+//      positions every update, so a body that crosses a tile boundary has migrated.
+//    * Bodies of the next tile that lie within a halo band (2 * max body radius) of a
+//      tile's right edge are that tile's ghosts. A tile resolves collisions among its own
+//      bodies and between its own bodies and its ghosts, so every touching pair is handled
+//      by exactly one tile (the lower one, for pairs spanning a boundary).
+//    * Tiles are never narrower than the halo, so a tile only ever touches bodies owned by
+//      itself and its two neighbors. Body updates and position finalization (which follow
+//      links to the linked body) run tiles 3 apart at the same time; collisions (which only
+//      reach right) run tiles 2 apart at the same time. No locks are needed.
+//    * Links are owned by the tile of the body they come FROM. A body with a link reaching
+//      further than a neighboring tile (e.g. a long consumption link) is updated and
+//      finalized serially after the parallel phases.
+//    * When the most loaded tile has more than imbalance_threshold times the mean load,
+//      tile boundaries move to the quantiles of the bodies' x positions (colonies pull
+//      boundaries toward them).
+//
+//  Results are deterministic for a given tiling and do not depend on the number of threads.
+//  With a single tile (the default), Update() is exactly SimplePhysics2D::Update().
+//  Collision callbacks run on worker threads; they should draw random numbers from
+//  GetCollisionRandom() (a per-tile generator reseeded from the physics generator every
+//  update) rather than from a shared generator.
+
+#ifndef EMP_TILED_PHYSICS_2D_H
+#define EMP_TILED_PHYSICS_2D_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "Physics2D.h"
+#include "../../shared/parallel/ThreadPool.h"
+
+#include "tools/Random.h"
+#include "tools/assert.h"
+#include "tools/functions.h"
+#include "tools/vector.h"
+
+namespace emp {
+
+  template <typename... OWNER_TYPES>
+  class TiledPhysics2D : public SimplePhysics2D<OWNER_TYPES...> {
+    protected:
+      using base_t = SimplePhysics2D<OWNER_TYPES...>;
+      using BODY_TYPE = typename base_t::BODY_TYPE;
+      using body_set_t = emp::vector<BODY_TYPE *>;
+
+      struct Tile {
+        double min_x;
+        double max_x;
+        emp::vector<body_set_t> owned;      // Bodies owned by this tile (one list per surface).
+        emp::vector<body_set_t> local;      // Owned bodies whose links stay within neighboring tiles.
+        body_set_t ghosts;                  // Next tile's bodies within the halo of max_x.
+        emp::vector<body_set_t> sector_set; // Collision sectors (reused every update).
+        emp::Random random;
+
+        Tile() : min_x(0.0), max_x(0.0) { ; }
+      };
+
+      emp::vector<std::unique_ptr<Tile>> tiles;
+      int num_active_tiles;                 // Tiles in use (never narrower than the halo).
+      std::unique_ptr<ThreadPool> thread_pool;
+      double imbalance_threshold;
+      double halo;                          // 2 * largest body radius, recomputed every update.
+      int rebalance_count;
+      emp::vector<body_set_t> far_bodies;   // Bodies with links beyond neighboring tiles.
+
+      // Random number generator for the tile (if any) that the current thread is working on.
+      static emp::Random *& TileRandom() {
+        static thread_local emp::Random *tile_random = nullptr;
+        return tile_random;
+      }
+
+      static int MixSeed(int seed, int tile_id) {
+        uint64_t x = ((uint64_t) (uint32_t) seed << 32) | (uint32_t) tile_id;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return (int) (x % 0x7FFFFFFE) + 1;    // emp::Random wants a positive seed.
+      }
+
+      int TileOf(double x) const {
+        for (int i = 0; i < num_active_tiles - 1; i++) {
+          if (x < tiles[i]->max_x) return i;
+        }
+        return num_active_tiles - 1;
+      }
+
+      // Run fun(tile_id) for every active tile, in phases of tiles that are 'stride' apart.
+      template <typename FUN>
+      void RunPhased(int stride, FUN fun) {
+        for (int phase = 0; phase < stride; phase++) {
+          const int num_in_phase = (num_active_tiles - phase + stride - 1) / stride;
+          if (num_in_phase <= 0) continue;
+          thread_pool->ParallelFor(num_in_phase, [&fun, phase, stride](int i) { fun(phase + i * stride); });
+        }
+      }
+
+      double FindMaxRadius() const {
+        double max_radius = 0.0;
+        for (auto *surface : this->surface_set) {
+          for (auto *body : surface->GetBodySet()) {
+            if (body->GetRadius() > max_radius) max_radius = body->GetRadius();
+          }
+        }
+        return max_radius;
+      }
+
+      // Decide how many tiles fit (each at least one halo wide) and make sure the current
+      // boundaries respect that width.
+      void FitTiles() {
+        const double width = this->GetWidth();
+        const int fit = (halo > 0.0) ? (int) (width / halo) : (int) tiles.size();
+        const int target = emp::to_range<int>(fit, 1, (int) tiles.size());
+        if (target != num_active_tiles) {
+          num_active_tiles = target;
+          SetUniformBounds();
+          return;
+        }
+        // Push boundaries apart (left to right, then right to left) so no tile is under a halo wide.
+        for (int i = 1; i < num_active_tiles; i++) {
+          tiles[i]->min_x = std::max(tiles[i]->min_x, tiles[i-1]->min_x + halo);
+          tiles[i-1]->max_x = tiles[i]->min_x;
+        }
+        for (int i = num_active_tiles - 1; i > 0; i--) {
+          tiles[i]->min_x = std::min(tiles[i]->min_x, tiles[i]->max_x - halo);
+          tiles[i-1]->max_x = tiles[i]->min_x;
+        }
+      }
+
+      void SetUniformBounds() {
+        const double width = this->GetWidth();
+        for (int i = 0; i < num_active_tiles; i++) {
+          tiles[i]->min_x = width * i / num_active_tiles;
+          tiles[i]->max_x = width * (i + 1) / num_active_tiles;
+        }
+        tiles[num_active_tiles - 1]->max_x = width;
+      }
+
+      // Move tile boundaries to the quantiles of body x positions.
+      void Rebalance() {
+        emp::vector<double> xs;
+        for (auto *surface : this->surface_set) {
+          for (auto *body : surface->GetBodySet()) xs.push_back(body->GetCenter().GetX());
+        }
+        if (xs.size() == 0) return;
+        for (int i = 1; i < num_active_tiles; i++) {
+          auto nth = xs.begin() + (xs.size() * i) / num_active_tiles;
+          std::nth_element(xs.begin(), nth, xs.end());
+          tiles[i]->min_x = emp::to_range<double>(*nth, 0.0, this->GetWidth());
+          tiles[i-1]->max_x = tiles[i]->min_x;
+        }
+        tiles[0]->min_x = 0.0;
+        tiles[num_active_tiles - 1]->max_x = this->GetWidth();
+        FitTiles();
+        rebalance_count++;
+      }
+
+      // Assign every body to the tile its center lies in.
+      void AssignBodies() {
+        const int num_surfaces = (int) this->surface_set.size();
+        for (int t = 0; t < num_active_tiles; t++) {
+          Tile &tile = *tiles[t];
+          tile.owned.resize(num_surfaces);
+          for (auto &bodies : tile.owned) bodies.resize(0);
+        }
+        for (int s = 0; s < num_surfaces; s++) {
+          for (auto *body : this->surface_set[s]->GetBodySet()) {
+            tiles[TileOf(body->GetCenter().GetX())]->owned[s].push_back(body);
+          }
+        }
+      }
+
+      // Split owned bodies into those that can be processed by their tile in parallel and
+      // those with links reaching past a neighboring tile (processed serially).
+      void SplitFarLinked() {
+        const int num_surfaces = (int) this->surface_set.size();
+        far_bodies.resize(num_surfaces);
+        for (auto &bodies : far_bodies) bodies.resize(0);
+        for (int t = 0; t < num_active_tiles; t++) {
+          Tile &tile = *tiles[t];
+          tile.local.resize(num_surfaces);
+          for (int s = 0; s < num_surfaces; s++) {
+            tile.local[s].resize(0);
+            for (auto *body : tile.owned[s]) {
+              bool is_far = false;
+              for (auto *link : body->GetFromLinks()) {
+                const int link_tile = TileOf(link->to->GetCenter().GetX());
+                if (link_tile < t - 1 || link_tile > t + 1) { is_far = true; break; }
+              }
+              if (is_far) far_bodies[s].push_back(body);
+              else tile.local[s].push_back(body);
+            }
+          }
+        }
+      }
+
+      // Collect each tile's ghosts: bodies of the next tile within the halo of its right edge.
+      void BuildGhosts() {
+        for (int t = 0; t < num_active_tiles; t++) {
+          Tile &tile = *tiles[t];
+          tile.ghosts.resize(0);
+          if (t + 1 == num_active_tiles) continue;
+          const double ghost_max_x = tile.max_x + halo;
+          for (auto &bodies : tiles[t+1]->owned) {
+            for (auto *body : bodies) {
+              if (body->GetCenter().GetX() < ghost_max_x) tile.ghosts.push_back(body);
+            }
+          }
+        }
+      }
+
+      // Same sector scheme as SimplePhysics2D::TestCollisions, over [min_x, max_x + halo).
+      // Ghosts go into sectors first and are only tested against this tile's own bodies.
+      void TestTileCollisions(Tile &tile) {
+        const double min_x = tile.min_x;
+        const double span_x = tile.max_x + halo - min_x;
+        const int num_cols = emp::to_range<int>(span_x / halo, 1, 32);
+        const int num_rows = emp::to_range<int>(this->GetHeight() / halo, 1, 32);
+        const int max_col = num_cols - 1;
+        const int max_row = num_rows - 1;
+        const double sector_width = span_x / (double) num_cols;
+        const double sector_height = this->GetHeight() / (double) num_rows;
+        tile.sector_set.resize(num_cols * num_rows);
+        for (auto &sector : tile.sector_set) sector.resize(0);
+        auto sector_of = [&](BODY_TYPE *body) {
+          const int col = emp::to_range<int>((body->GetCenter().GetX() - min_x) / sector_width, 0, max_col);
+          const int row = emp::to_range<int>(body->GetCenter().GetY() / sector_height, 0, max_row);
+          return col + row * num_cols;
+        };
+        for (auto *ghost : tile.ghosts) tile.sector_set[sector_of(ghost)].push_back(ghost);
+        for (auto &bodies : tile.owned) {
+          for (auto *body : bodies) {
+            const int cur_sector = sector_of(body);
+            const int cur_col = cur_sector % num_cols;
+            const int cur_row = cur_sector / num_cols;
+            for (int i = std::max(0, cur_col-1); i <= std::min(cur_col+1, max_col); i++) {
+              for (int j = std::max(0, cur_row-1); j <= std::min(cur_row+1, max_row); j++) {
+                for (auto *body2 : tile.sector_set[i + num_cols * j]) this->CollideBodies(body, body2);
+              }
+            }
+            tile.sector_set[cur_sector].push_back(body);
+          }
+        }
+      }
+
+      // Remove bodies that are flagged (or test) for removal, as SimplePhysics2D::Update does.
+      template <typename TEST>
+      void RemoveBodies(TEST test) {
+        for (auto *surface : this->surface_set) {
+          auto &surface_body_set = surface->GetBodySet();
+          int cur_size = (int) surface_body_set.size();
+          int cur_id = 0;
+          while (cur_id < cur_size) {
+            emp_assert(surface_body_set[cur_id] != nullptr);
+            if (test(surface_body_set[cur_id])) {
+              delete surface_body_set[cur_id];
+              cur_size--;
+              surface_body_set[cur_id] = surface_body_set[cur_size];
+            } else {
+              cur_id++;
+            }
+          }
+          surface_body_set.resize(cur_size);
+        }
+      }
+
+      void TiledUpdate() {
+        this->update_sig.Trigger();
+        RemoveBodies([](BODY_TYPE *body) { return body->ToDestroy(); });
+
+        // Body updates (movement, growth, link distances).
+        FitTiles();
+        AssignBodies();
+        int max_load = 0;
+        int total_load = 0;
+        for (int t = 0; t < num_active_tiles; t++) {
+          int load = 0;
+          for (auto &bodies : tiles[t]->owned) load += (int) bodies.size();
+          max_load = std::max(max_load, load);
+          total_load += load;
+        }
+        if (total_load > 0 && max_load > imbalance_threshold * total_load / num_active_tiles) {
+          Rebalance();
+          AssignBodies();
+        }
+        SplitFarLinked();
+        RunPhased(3, [this](int t) {
+          Tile &tile = *tiles[t];
+          for (int s = 0; s < (int) tile.local.size(); s++) {
+            const double f = this->surface_set[s]->GetFriction();
+            for (auto *body : tile.local[s]) body->BodyUpdate(f);
+          }
+        });
+        for (int s = 0; s < (int) far_bodies.size(); s++) {
+          const double f = this->surface_set[s]->GetFriction();
+          for (auto *body : far_bodies[s]) body->BodyUpdate(f);
+        }
+
+        // Bodies have moved (and grown): migrate them to their new tiles, then exchange halos
+        // and collide.
+        halo = 2.0 * FindMaxRadius();
+        FitTiles();
+        AssignBodies();
+        BuildGhosts();
+        const int update_seed = this->random_ptr->GetInt(1, 0x7FFFFFFF);
+        RunPhased(2, [this, update_seed](int t) {
+          Tile &tile = *tiles[t];
+          tile.random.ResetSeed(MixSeed(update_seed, t));
+          TileRandom() = &tile.random;
+          TestTileCollisions(tile);
+          TileRandom() = nullptr;
+        });
+
+        // Make sure all bodies are in a legal position.
+        SplitFarLinked();
+        const Point<double> max_pos = *this->max_pos;
+        RunPhased(3, [this, &max_pos](int t) {
+          for (auto &bodies : tiles[t]->local) {
+            for (auto *body : bodies) body->FinalizePosition(max_pos);
+          }
+        });
+        for (auto &bodies : far_bodies) {
+          for (auto *body : bodies) body->FinalizePosition(max_pos);
+        }
+
+        // Test bodies for stress-induced removal.
+        RemoveBodies([](BODY_TYPE *body) { return body->ExceedsStressThreshold(); });
+      }
+
+    public:
+      TiledPhysics2D()
+        : base_t(), num_active_tiles(0), thread_pool(new ThreadPool(1)), imbalance_threshold(1.5),
+          halo(0.0), rebalance_count(0)
+      {
+        ConfigTiles(1, 1);
+      }
+
+      // Split the world into (up to) num_tiles tiles, updated by num_threads threads. Tiles are
+      // rebalanced when the busiest one holds more than imbalance_threshold times the mean.
+      void ConfigTiles(int num_tiles, int num_threads, double _imbalance_threshold = 1.5) {
+        emp_assert(num_tiles > 0 && num_threads > 0 && _imbalance_threshold >= 1.0);
+        tiles.resize(0);
+        for (int i = 0; i < num_tiles; i++) tiles.emplace_back(new Tile());
+        num_active_tiles = 0;     // Bounds get set on the next update.
+        if (num_threads != thread_pool->GetNumThreads()) thread_pool.reset(new ThreadPool(num_threads));
+        imbalance_threshold = _imbalance_threshold;
+      }
+
+      int GetNumTiles() const { return (int) tiles.size(); }
+      int GetNumActiveTiles() const { return num_active_tiles; }
+      int GetNumThreads() const { return thread_pool->GetNumThreads(); }
+      int GetRebalanceCount() const { return rebalance_count; }
+      double GetTileMinX(int tile_id) const { return tiles[tile_id]->min_x; }
+      double GetTileMaxX(int tile_id) const { return tiles[tile_id]->max_x; }
+
+      // Random number generator for collision callbacks: the tile's own generator while tiles
+      // are resolving collisions, the physics generator otherwise.
+      emp::Random * GetCollisionRandom() {
+        emp::Random *tile_random = TileRandom();
+        return (tile_random != nullptr) ? tile_random : this->random_ptr;
+      }
+
+      // Progress physics by a single time step.
+      void Update() {
+        emp_assert(this->configured);
+        halo = 2.0 * FindMaxRadius();
+        if (tiles.size() <= 1 || halo <= 0.0 || this->GetWidth() < 2.0 * halo) {
+          num_active_tiles = 0;
+          base_t::Update();
+          return;
+        }
+        TiledUpdate();
+      }
+  };
+}
+
+#endif
@@ -5,6 +5,8 @@
 #ifndef SIMPLEORGANISM_H
 #define SIMPLEORGANISM_H
 
+#include <cstdint>
+
 #include "tools/BitVector.h"
 #include "tools/Random.h"
 
@@ -24,6 +26,7 @@ class SimpleOrganism {
     bool has_body;
     double energy;
     int resources_collected;
+    uint32_t entity_id;       // Assigned by the population manager; 0 until then.
 
   public:
     emp::BitVector genome;
@@ -36,6 +39,7 @@ class SimpleOrganism {
         has_body(false),
         energy(0.0),
         resources_collected(0.0),
+        entity_id(0),
         genome(genome_length, false)
     {
       AttachBody(new Body_t(_p));
@@ -53,6 +57,7 @@ class SimpleOrganism {
          has_body(other.has_body),
          energy(other.GetEnergy()),
          resources_collected(other.GetResourcesCollected()),
+         entity_id(0),
          genome(other.genome)
     {
       if (has_body) {
@@ -75,6 +80,7 @@ class SimpleOrganism {
     double GetEnergy() const { return energy; }
     int GetResourcesCollected() const { return resources_collected; }
     double GetBirthTime() const { return birth_time; }
+    uint32_t GetEntityID() const { return entity_id; }
     bool GetDetachOnBirth() const { emp_assert(has_body); return body->GetDetachOnRepro(); }
     double GetMembraneStrength() const { return membrane_strengh; }
     Body_t * GetBodyPtr() { emp_assert(has_body); return body; }
@@ -106,6 +112,7 @@ class SimpleOrganism {
     }
     void SetEnergy(double e) { energy = e; }
     void SetBirthTime(double t) { birth_time = t; }
+    void SetEntityID(uint32_t id) { entity_id = id; }
     void SetColorID(int id) { emp_assert(has_body); body->SetColorID(id); }
     void SetColorID() {
       emp_assert(has_body);
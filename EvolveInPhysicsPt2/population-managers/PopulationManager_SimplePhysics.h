@@ -5,10 +5,11 @@
 #ifndef POPULATION_MANAGER_SIMPLE_PHYSICS_H
 #define POPULATION_MANAGER_SIMPLE_PHYSICS_H
 
+#include <cstdint>
 #include <iostream>
 #include <limits>
 
-#include "../geometry/Physics2D.h"
+#include "../geometry/TiledPhysics2D.h"
 #include "../resources/SimpleResource.h"
 
 #include "evo/PopulationManager.h"
@@ -37,7 +38,7 @@ class PopulationManager_SimplePhysics {
     using Org_t = ORG;                  // Just here for consistency
     using Resource_t = SimpleResource;
     using PhysicsBody_t = CircleBody2D;
-    using Physics_t = SimplePhysics2D<SimpleResource, ORG>;
+    using Physics_t = TiledPhysics2D<SimpleResource, ORG>;
     // TODO
     Physics_t physics;
     emp::vector<Org_t*> population;
@@ -58,6 +59,8 @@ class PopulationManager_SimplePhysics {
 
     double movement_noise;
 
+    uint32_t next_entity_id;     // Every organism and resource added gets its own ID (from 1).
+
     // Useful things to not have to look up all of the time.
     static constexpr int RESOURCE_TYPE_ID = Physics_t::template GetTypeID<Resource_t>();
     static constexpr int ORG_TYPE_ID = Physics_t::template GetTypeID<ORG>();
@@ -73,7 +76,8 @@ class PopulationManager_SimplePhysics {
         max_resource_count(1),
         resource_radius(1.0),
         resource_value(1.0),
-        movement_noise(0.1)
+        movement_noise(0.1),
+        next_entity_id(1)
     {
       // TODO: allow collision callbacks (multiple?) to be registered.
       physics.RegisterCollisionCallback([this](PhysicsBody_t *b1, PhysicsBody_t *b2) { this->PhysicsCollisionCallback(b1, b2); });
@@ -104,6 +108,7 @@ class PopulationManager_SimplePhysics {
     int AddOrg(Org_t *new_org) {
       int pos = this->GetSize();
       population.push_back(new_org);
+      new_org->SetEntityID(next_entity_id++);
       physics.AddOrgBody(new_org, new_org->GetBodyPtr());
       return pos;
     }
@@ -111,6 +116,7 @@ class PopulationManager_SimplePhysics {
     int AddResource(Resource_t *new_res) {
       int pos = this->GetNumResources();
       resources.push_back(new_res);
+      new_res->SetEntityID(next_entity_id++);
       physics.AddResourceBody(new_res, new_res->GetBodyPtr());
       return pos;
     }
@@ -157,8 +163,9 @@ class PopulationManager_SimplePhysics {
           res = static_cast<Resource_t*>(body1->GetOwnerPtr());
         }
         // If organism manages to eat resource and they are not already linked,
-        // add a link org--->res.
-        if (random_ptr->P(org->GetResourceConsumptionProb(*res))) {
+        // add a link org--->res. (This may run on a physics worker thread, so use the
+        // physics' collision random number generator.)
+        if (physics.GetCollisionRandom()->P(org->GetResourceConsumptionProb(*res))) {
           // Organism consumes resource!
           if (!org->GetBody().IsLinked(res->GetBody())) {
             double strength;
@@ -0,0 +1,458 @@
+/*
+  recording/TrajectoryFile.h
+    Defines TrajectoryWriter, which records where every body is, update after update, and
+    TrajectoryReader, which gets any recorded frame back.
+
+    Attach(physics) hooks the writer onto the physics' update signal (RegisterUpdateCallback);
+    it then records a frame every 'interval' physics updates. A frame is the state the
+    update starts from: one fixed-width record per live body (organism bodies first, then
+    resource bodies) holding its position, radius, color and the entity ID of the organism or
+    resource it belongs to (assigned by the population manager), so bodies can be followed
+    from frame to frame. Bodies that physics has yet to remove (marked for destruction, or
+    whose owner is gone) are left out.
+
+    Files:
+      NAME      Header (magic, version, format, interval, world size, chunk size), then the
+                frames. The file grows chunk_bytes at a time; each chunk is memory-mapped
+                while frames are copied into it, and no frame straddles two chunks.
+      NAME.idx  Frame index: one fixed-size entry (update, body counts, offset) per frame.
+    Full chunks are handed to a background thread, which syncs them to disk, unmaps them and
+    only then appends their frames to the index. So everything in the index is on disk, and
+    the simulation never waits on I/O unless the flush thread falls a whole chunk behind.
+
+    Formats (bytes per body):
+      FLOAT32    (20) x, y, radius as floats; 32-bit color; 32-bit entity ID.
+      FLOAT16    (12) x, y, radius as half floats; 16-bit color; 32-bit entity ID.
+      QUANTIZED  (12) x, y as 16-bit fractions of the world size; radius as a half float;
+                 16-bit color; 32-bit entity ID.
+    Problems opening files print a message; check IsOK().
+*/
+
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+enum class TRAJECTORY_FORMAT : uint32_t { FLOAT32 = 0, FLOAT16 = 1, QUANTIZED = 2 };
+
+// One body in one frame, as read back.
+struct TrajectoryBody {
+  float x;
+  float y;
+  float radius;
+  uint32_t color_id;
+  uint32_t entity_id;
+};
+
+struct TrajectoryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t format;
+  uint32_t interval;
+  uint32_t record_size;
+  double width;
+  double height;
+  uint64_t chunk_bytes;
+  uint64_t reserved[3];
+};
+
+struct TrajectoryIndexEntry {
+  uint64_t offset;            // Where the frame's records start in the data file.
+  uint32_t update;
+  uint32_t num_bodies;
+  uint32_t num_organisms;     // The first num_organisms records are organism bodies.
+  uint32_t reserved;
+};
+
+namespace trajectory {
+  constexpr uint32_t VERSION = 2;
+
+  inline uint32_t GetRecordSize(TRAJECTORY_FORMAT format) { return (format == TRAJECTORY_FORMAT::FLOAT32) ? 20 : 12; }
+
+  // IEEE half precision (round to nearest; overflow goes to infinity, tiny values to zero).
+  inline uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000);
+    const int exponent = (int) ((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+    if (((bits >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0);   // Inf / NaN
+    if (exponent <= 0) return sign;
+    mantissa += 0x1000;                                     // Round to nearest.
+    if (mantissa & 0x800000) return (exponent + 1 >= 31) ? (sign | 0x7c00) : (uint16_t) (sign | ((exponent + 1) << 10));
+    if (exponent >= 31) return sign | 0x7c00;
+    return (uint16_t) (sign | (exponent << 10) | (mantissa >> 13));
+  }
+
+  inline float HalfToFloat(uint16_t half) {
+    const uint32_t sign = (uint32_t) (half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0) bits = sign;                                         // Zero (no subnormals).
+    else if (exponent == 31) bits = sign | 0x7f800000 | (mantissa << 13);   // Inf / NaN
+    else bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  inline uint16_t Quantize(double value, double max) {
+    const double frac = std::min(1.0, std::max(0.0, value / max));
+    return (uint16_t) std::lround(frac * 65535.0);
+  }
+}
+
+class TrajectoryWriter {
+  private:
+    struct Chunk {
+      char *data;
+      size_t size;
+      emp::vector<TrajectoryIndexEntry> entries;
+    };
+
+    std::string filename;
+    TRAJECTORY_FORMAT format;
+    uint32_t record_size;
+    int interval;
+    double width;
+    double height;
+    size_t chunk_bytes;
+    int data_fd;
+    int index_fd;
+    bool ok;
+
+    Chunk current;              // Chunk being filled (mapped at current_start).
+    uint64_t current_start;
+    size_t current_used;
+    uint64_t file_size;
+    uint32_t updates_seen;
+    int num_frames;
+
+    // Flush thread.
+    std::thread flusher;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    std::deque<Chunk> retired;
+    bool stopping;
+    static constexpr int MAX_RETIRED = 2;    // Record blocks if the flush thread is this far behind.
+
+    bool Fail(const std::string &what) {
+      std::cerr << "Trajectory " << filename << ": " << what << " (" << std::strerror(errno) << ")" << std::endl;
+      return ok = false;
+    }
+
+    // Map a fresh chunk with room for at least min_size bytes after the end of the file.
+    // Mappings start on a page boundary, so after a Flush the chunk begins with the (already
+    // written) tail of the last page.
+    bool StartChunk(size_t min_size) {
+      const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+      current_start = file_size / page * page;
+      const size_t skip = (size_t) (file_size - current_start);
+      size_t size = std::max(chunk_bytes, min_size + skip);
+      size = (size + page - 1) / page * page;
+      file_size = current_start + size;
+      if (ftruncate(data_fd, (off_t) file_size) != 0) return Fail("could not grow file");
+      void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, data_fd, (off_t) current_start);
+      if (mapping == MAP_FAILED) return Fail("could not map chunk");
+      current.data = static_cast<char *>(mapping);
+      current.size = size;
+      current.entries.resize(0);
+      current_used = skip;
+      return true;
+    }
+
+    void RetireChunk() {
+      if (current.data == nullptr) return;
+      std::unique_lock<std::mutex> lock(mutex);
+      work_done.wait(lock, [this]() { return (int) retired.size() < MAX_RETIRED; });
+      retired.push_back(current);
+      current.data = nullptr;
+      current.entries.clear();
+      lock.unlock();
+      work_ready.notify_one();
+    }
+
+    void RunFlusher() {
+      while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_ready.wait(lock, [this]() { return stopping || retired.size() > 0; });
+        if (retired.size() == 0) return;    // Stopping, and nothing left to do.
+        Chunk chunk = retired.front();
+        lock.unlock();
+        msync(chunk.data, chunk.size, MS_SYNC);
+        munmap(chunk.data, chunk.size);
+        const size_t index_bytes = chunk.entries.size() * sizeof(TrajectoryIndexEntry);
+        if (index_bytes > 0 && write(index_fd, chunk.entries.data(), index_bytes) != (ssize_t) index_bytes) {
+          std::cerr << "Trajectory " << filename << ": could not write index" << std::endl;
+        }
+        lock.lock();
+        retired.pop_front();
+        lock.unlock();
+        work_done.notify_all();
+      }
+    }
+
+    // Encode the bodies that are still live (see the top of the file) and owned by OWNERs;
+    // returns how many were written.
+    template <typename OWNER, typename BODY>
+    uint32_t EncodeBodies(char *out, const emp::vector<BODY *> &bodies) const {
+      uint32_t count = 0;
+      for (auto *body : bodies) {
+        void *owner = body->GetOwnerPtr();
+        if (body->ToDestroy() || owner == nullptr) continue;
+        EncodeBody(out, *body, static_cast<OWNER *>(owner)->GetEntityID());
+        out += record_size;
+        count++;
+      }
+      return count;
+    }
+
+    template <typename BODY>
+    void EncodeBody(char *out, const BODY &body, uint32_t entity_id) const {
+      const double x = body.GetCenter().GetX();
+      const double y = body.GetCenter().GetY();
+      if (format == TRAJECTORY_FORMAT::FLOAT32) {
+        const float values[3] = { (float) x, (float) y, (float) body.GetRadius() };
+        const uint32_t color_id = body.GetColorID();
+        std::memcpy(out, values, sizeof(values));
+        std::memcpy(out + 12, &color_id, 4);
+        std::memcpy(out + 16, &entity_id, 4);
+        return;
+      }
+      uint16_t values[4];
+      if (format == TRAJECTORY_FORMAT::FLOAT16) {
+        values[0] = trajectory::FloatToHalf((float) x);
+        values[1] = trajectory::FloatToHalf((float) y);
+      } else {
+        values[0] = trajectory::Quantize(x, width);
+        values[1] = trajectory::Quantize(y, height);
+      }
+      values[2] = trajectory::FloatToHalf((float) body.GetRadius());
+      values[3] = (uint16_t) body.GetColorID();
+      std::memcpy(out, values, sizeof(values));
+      std::memcpy(out + 8, &entity_id, 4);
+    }
+
+  public:
+    // Record a frame every 'interval' updates into filename (and filename.idx), replacing
+    // whatever was there. width and height are the world's (QUANTIZED needs them).
+    TrajectoryWriter(const std::string &_filename, TRAJECTORY_FORMAT _format, int _interval,
+                     double _width, double _height, size_t _chunk_bytes = 64 << 20)
+      : filename(_filename), format(_format), record_size(trajectory::GetRecordSize(_format)),
+        interval(std::max(1, _interval)), width(_width), height(_height), chunk_bytes(_chunk_bytes),
+        data_fd(-1), index_fd(-1), ok(true), current_start(0), current_used(0), file_size(0),
+        updates_seen(0), num_frames(0), stopping(false)
+    {
+      current.data = nullptr;
+      current.size = 0;
+      data_fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (data_fd < 0) { Fail("could not open"); return; }
+      index_fd = open((filename + ".idx").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (index_fd < 0) { Fail("could not open index"); return; }
+      if (!StartChunk(sizeof(TrajectoryHeader))) return;
+      TrajectoryHeader header;
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, "EMPTRAJ", sizeof(header.magic));
+      header.version = trajectory::VERSION;
+      header.format = (uint32_t) format;
+      header.interval = (uint32_t) interval;
+      header.record_size = record_size;
+      header.width = width;
+      header.height = height;
+      header.chunk_bytes = chunk_bytes;
+      std::memcpy(current.data, &header, sizeof(header));
+      current_used = sizeof(header);
+      flusher = std::thread(&TrajectoryWriter::RunFlusher, this);
+    }
+    TrajectoryWriter(const TrajectoryWriter &) = delete;
+    TrajectoryWriter & operator=(const TrajectoryWriter &) = delete;
+
+    ~TrajectoryWriter() { Close(); }
+
+    bool IsOK() const { return ok; }
+    int GetNumFrames() const { return num_frames; }
+
+    // Record from now on, every interval-th time physics starts an update. The writer must
+    // outlive physics (or at least its updates). ORG and RESOURCE are the types that own
+    // physics' organism and resource bodies (they provide GetEntityID()).
+    template <typename ORG, typename RESOURCE, typename PHYSICS>
+    void Attach(PHYSICS &physics) {
+      PHYSICS *physics_ptr = &physics;
+      physics.RegisterUpdateCallback([this, physics_ptr]() {
+        if (updates_seen++ % interval != 0) return;
+        RecordFrame<ORG, RESOURCE>(updates_seen - 1, physics_ptr->GetConstOrgBodySet(), physics_ptr->GetConstResourceBodySet());
+      });
+    }
+
+    template <typename ORG, typename RESOURCE, typename BODY>
+    void RecordFrame(uint32_t update, const emp::vector<BODY *> &org_bodies, const emp::vector<BODY *> &resource_bodies) {
+      if (!ok) return;
+      // Make room for every body; dead ones are skipped, so the frame may come out shorter.
+      const size_t max_frame_bytes = (org_bodies.size() + resource_bodies.size()) * record_size;
+      if (current_used + max_frame_bytes > current.size) {
+        RetireChunk();
+        if (!StartChunk(max_frame_bytes)) return;
+      }
+      char *out = current.data + current_used;
+      const uint32_t num_organisms = EncodeBodies<ORG>(out, org_bodies);
+      const uint32_t num_resources = EncodeBodies<RESOURCE>(out + (size_t) num_organisms * record_size, resource_bodies);
+      TrajectoryIndexEntry entry;
+      entry.offset = current_start + current_used;
+      entry.update = update;
+      entry.num_bodies = num_organisms + num_resources;
+      entry.num_organisms = num_organisms;
+      entry.reserved = 0;
+      current.entries.push_back(entry);
+      current_used += (size_t) entry.num_bodies * record_size;
+      num_frames++;
+    }
+
+    // Hand everything recorded so far to the flush thread and wait until it is on disk and
+    // indexed.
+    void Flush() {
+      if (!ok || current.data == nullptr) return;
+      const uint64_t used = current_start + current_used;
+      RetireChunk();
+      std::unique_lock<std::mutex> lock(mutex);
+      work_done.wait(lock, [this]() { return retired.size() == 0; });
+      lock.unlock();
+      // Carry on in a fresh chunk; drop the unused tail of the old one.
+      file_size = used;
+      StartChunk(0);
+    }
+
+    // Flush, stop the flush thread and trim the file. Called by the destructor.
+    void Close() {
+      if (flusher.joinable()) {
+        const uint64_t used = current_start + current_used;
+        RetireChunk();
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          stopping = true;
+        }
+        work_ready.notify_one();
+        flusher.join();
+        if (ok && ftruncate(data_fd, (off_t) used) != 0) Fail("could not trim file");
+      }
+      if (data_fd >= 0) { close(data_fd); data_fd = -1; }
+      if (index_fd >= 0) { fsync(index_fd); close(index_fd); index_fd = -1; }
+    }
+};
+
+class TrajectoryReader {
+  private:
+    void *mapping;
+    size_t mapping_size;
+    TrajectoryHeader header;
+    emp::vector<TrajectoryIndexEntry> index;
+    bool ok;
+
+    bool Fail(const std::string &filename, const std::string &what) {
+      std::cerr << "Could not read trajectory " << filename << ": " << what << std::endl;
+      return ok = false;
+    }
+
+  public:
+    TrajectoryReader(const std::string &filename) : mapping(MAP_FAILED), mapping_size(0), ok(true) {
+      std::memset(&header, 0, sizeof(header));
+      const int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) { Fail(filename, std::strerror(errno)); return; }
+      struct stat file_stat;
+      if (fstat(fd, &file_stat) == 0) mapping_size = (size_t) file_stat.st_size;
+      if (mapping_size >= sizeof(TrajectoryHeader)) mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (mapping == MAP_FAILED) { Fail(filename, "file too short or could not be mapped"); return; }
+      std::memcpy(&header, mapping, sizeof(header));
+      if (std::memcmp(header.magic, "EMPTRAJ", sizeof(header.magic)) != 0) { Fail(filename, "not a trajectory file"); return; }
+      if (header.version != trajectory::VERSION) { Fail(filename, "unsupported version " + std::to_string(header.version)); return; }
+
+      const int index_fd = open((filename + ".idx").c_str(), O_RDONLY);
+      if (index_fd < 0) { Fail(filename + ".idx", std::strerror(errno)); return; }
+      TrajectoryIndexEntry entry;
+      while (read(index_fd, &entry, sizeof(entry)) == (ssize_t) sizeof(entry)) {
+        // Frames past the end of the data (e.g., the run died before trimming) are dropped.
+        if (entry.offset + (uint64_t) entry.num_bodies * header.record_size > mapping_size) break;
+        index.push_back(entry);
+      }
+      close(index_fd);
+    }
+    TrajectoryReader(const TrajectoryReader &) = delete;
+    TrajectoryReader & operator=(const TrajectoryReader &) = delete;
+
+    ~TrajectoryReader() { if (mapping != MAP_FAILED) munmap(mapping, mapping_size); }
+
+    bool IsOK() const { return ok; }
+    TRAJECTORY_FORMAT GetFormat() const { return (TRAJECTORY_FORMAT) header.format; }
+    int GetInterval() const { return (int) header.interval; }
+    double GetWidth() const { return header.width; }
+    double GetHeight() const { return header.height; }
+
+    int GetNumFrames() const { return (int) index.size(); }
+    int GetUpdate(int frame) const { return (int) index[frame].update; }
+    int GetNumBodies(int frame) const { return (int) index[frame].num_bodies; }
+    int GetNumOrganisms(int frame) const { return (int) index[frame].num_organisms; }
+
+    // Which frame was recorded at update (or the last one before it)? -1 if none.
+    int FindFrame(int update) const {
+      auto it = std::upper_bound(index.begin(), index.end(), (uint32_t) update,
+                                 [](uint32_t u, const TrajectoryIndexEntry &e) { return u < e.update; });
+      return (int) (it - index.begin()) - 1;
+    }
+
+    TrajectoryBody GetBody(int frame, int body_id) const {
+      emp_assert(frame >= 0 && frame < GetNumFrames() && body_id >= 0 && body_id < GetNumBodies(frame));
+      const char *in = static_cast<const char *>(mapping) + index[frame].offset + (size_t) body_id * header.record_size;
+      TrajectoryBody body;
+      if (GetFormat() == TRAJECTORY_FORMAT::FLOAT32) {
+        float values[3];
+        std::memcpy(values, in, sizeof(values));
+        body.x = values[0];
+        body.y = values[1];
+        body.radius = values[2];
+        std::memcpy(&body.color_id, in + 12, 4);
+        std::memcpy(&body.entity_id, in + 16, 4);
+        return body;
+      }
+      uint16_t values[4];
+      std::memcpy(values, in, sizeof(values));
+      if (GetFormat() == TRAJECTORY_FORMAT::FLOAT16) {
+        body.x = trajectory::HalfToFloat(values[0]);
+        body.y = trajectory::HalfToFloat(values[1]);
+      } else {
+        body.x = (float) (values[0] / 65535.0 * header.width);
+        body.y = (float) (values[1] / 65535.0 * header.height);
+      }
+      body.radius = trajectory::HalfToFloat(values[2]);
+      body.color_id = values[3];
+      std::memcpy(&body.entity_id, in + 8, 4);
+      return body;
+    }
+
+    emp::vector<TrajectoryBody> GetFrame(int frame) const {
+      emp::vector<TrajectoryBody> bodies(GetNumBodies(frame));
+      for (int i = 0; i < (int) bodies.size(); i++) bodies[i] = GetBody(frame, i);
+      return bodies;
+    }
+};
+
+#endif
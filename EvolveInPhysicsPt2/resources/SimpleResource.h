@@ -6,6 +6,8 @@
 #ifndef SIMPLERESOURCE_H
 #define SIMPLERESOURCE_H
 
+#include <cstdint>
+
 #include "../geometry/Body2D.h"
 
 class SimpleResource;
@@ -31,6 +33,7 @@ class SimpleResource {
     double value;
     double age;
     bool has_body;
+    uint32_t entity_id;               // Assigned by the population manager; 0 until then.
 
     void OnBodyDestruction() {
       has_body = false;
@@ -38,7 +41,8 @@ class SimpleResource {
 
   public:
     SimpleResource(const emp::Circle<double> &_p, double value = 1.0)
-      : age(0.0)
+      : age(0.0),
+        entity_id(0)
     {
       AttachBody(new Body_t(_p));
       body->SetDetachOnRepro(true);
@@ -48,7 +52,8 @@ class SimpleResource {
 
     SimpleResource(const SimpleResource &other)
       : value(other.GetValue()),
-        age(0.0)
+        age(0.0),
+        entity_id(0)
     {
       AttachBody(new Body_t(other.GetConstBody().GetPerimeter()));
       body->SetDetachOnRepro(other.GetConstBody().GetDetachOnRepro());
@@ -64,6 +69,7 @@ class SimpleResource {
 
     double GetValue() const { return value; }
     double GetAge() const { return age; }
+    uint32_t GetEntityID() const { return entity_id; }
     Body_t * GetBodyPtr() { emp_assert(body); return body; }
     Body_t & GetBody() { emp_assert(body); return *body; }
     const Body_t & GetConstBody() const { emp_assert(has_body); return *body; }
@@ -72,6 +78,7 @@ class SimpleResource {
 
     void SetValue(double value) { this->value = value; }
     void SetAge(double age) { this->age = age; }
+    void SetEntityID(uint32_t id) { entity_id = id; }
     int IncAge() { return ++age; }
     void SetColorID(int id) { emp_assert(has_body); body->SetColorID(id); }
 
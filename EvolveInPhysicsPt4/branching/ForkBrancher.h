@@ -0,0 +1,178 @@
+/*
+  branching/ForkBrancher.h
+    Defines ForkBrancher, which sends a running world down many alternative futures at once
+    by forking the process: every branch starts as a copy-on-write image of the parent, so
+    making one costs a fork (milliseconds), not a save and reload of the whole world.
+
+    Run(num_branches, branch_fun, on_result) forks one child per branch (at most
+    max_children alive at a time). The child calls branch_fun(branch_id) (which tweaks its
+    copy of the world and runs it on), sends the row it returns back up a pipe and exits;
+    the parent hands each row to on_result(branch_id, row) as it arrives.
+
+    * Fork only from a single-threaded parent: threads other than the forking one do not
+      exist in the child (so set any thread pools to one thread first; a branch may start
+      its own).
+    * Children leave with _exit, so nothing the parent owns (files, buffered output) is
+      flushed or cleaned up twice. Output is flushed before every fork.
+    * A branch that crashes or exits without a full row prints a message and is skipped;
+      Run then returns false.
+*/
+
+#ifndef FORK_BRANCHER_H
+#define FORK_BRANCHER_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+class ForkBrancher {
+  public:
+    using row_t = emp::vector<double>;
+    using branch_fun_t = std::function<row_t(int)>;
+    using result_fun_t = std::function<void(int, const row_t &)>;
+
+  private:
+    struct Child {
+      int branch_id;
+      pid_t pid;
+      int fd;                   // Read end of the child's pipe.
+      std::string received;
+    };
+
+    int max_children;
+    double fork_seconds;        // Total time spent in fork() (in the parent).
+    int num_forks;
+
+    static bool WriteAll(int fd, const char *data, size_t size) {
+      while (size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= (size_t) written;
+      }
+      return true;
+    }
+
+    // Runs in the child: never returns.
+    static void RunChild(int branch_id, int fd, const branch_fun_t &branch_fun) {
+      const row_t row = branch_fun(branch_id);
+      const uint32_t num_values = (uint32_t) row.size();
+      bool ok = WriteAll(fd, reinterpret_cast<const char *>(&num_values), sizeof(num_values));
+      ok = ok && (num_values == 0 || WriteAll(fd, reinterpret_cast<const char *>(row.data()), num_values * sizeof(double)));
+      close(fd);
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(ok ? 0 : 1);
+    }
+
+    // Reap a child whose pipe has closed; pass its row on if it finished cleanly.
+    bool Finish(Child &child, const result_fun_t &on_result) {
+      close(child.fd);
+      int status = 0;
+      while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR) { ; }
+      uint32_t num_values = 0;
+      bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && child.received.size() >= sizeof(num_values);
+      if (ok) {
+        std::memcpy(&num_values, child.received.data(), sizeof(num_values));
+        ok = child.received.size() == sizeof(num_values) + num_values * sizeof(double);
+      }
+      if (!ok) {
+        std::cerr << "Branch " << child.branch_id << " failed";
+        if (WIFSIGNALED(status)) std::cerr << " (signal " << WTERMSIG(status) << ")";
+        std::cerr << std::endl;
+        return false;
+      }
+      row_t row(num_values);
+      if (num_values > 0) std::memcpy(row.data(), child.received.data() + sizeof(num_values), num_values * sizeof(double));
+      on_result(child.branch_id, row);
+      return true;
+    }
+
+  public:
+    ForkBrancher(int _max_children) : max_children(_max_children), fork_seconds(0.0), num_forks(0) {
+      emp_assert(max_children > 0);
+    }
+
+    int GetMaxChildren() const { return max_children; }
+    int GetNumForks() const { return num_forks; }
+    // Mean wall-clock time the parent spent creating one branch.
+    double GetMeanForkSeconds() const { return (num_forks > 0) ? fork_seconds / num_forks : 0.0; }
+
+    bool Run(int num_branches, const branch_fun_t &branch_fun, const result_fun_t &on_result) {
+      emp::vector<Child> children;
+      bool all_ok = true;
+      int next_branch = 0;
+      while (next_branch < num_branches || children.size() > 0) {
+        // Start branches until max_children are running.
+        while (next_branch < num_branches && (int) children.size() < max_children) {
+          int fds[2];
+          if (pipe(fds) != 0) {
+            std::cerr << "Could not create a pipe for branch " << next_branch << " (" << std::strerror(errno) << ")" << std::endl;
+            num_branches = next_branch;   // Start no more, but collect the ones running.
+            all_ok = false;
+            break;
+          }
+          std::cout.flush();
+          std::cerr.flush();
+          std::fflush(nullptr);
+          const auto start_time = std::chrono::steady_clock::now();
+          const pid_t pid = fork();
+          if (pid == 0) {
+            close(fds[0]);
+            for (auto &child : children) close(child.fd);
+            RunChild(next_branch, fds[1], branch_fun);
+          }
+          const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+          close(fds[1]);
+          if (pid < 0) {
+            std::cerr << "Could not fork branch " << next_branch << " (" << std::strerror(errno) << ")" << std::endl;
+            close(fds[0]);
+            num_branches = next_branch;
+            all_ok = false;
+            break;
+          }
+          fork_seconds += elapsed.count();
+          num_forks++;
+          children.push_back({ next_branch, pid, fds[0], "" });
+          next_branch++;
+        }
+
+        // Collect whatever the running branches have sent; reap those that are done.
+        if (children.size() == 0) break;
+        emp::vector<pollfd> poll_fds(children.size());
+        for (int i = 0; i < (int) children.size(); i++) poll_fds[i] = { children[i].fd, POLLIN, 0 };
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+          emp_assert(errno == EINTR);
+          continue;
+        }
+        for (int i = (int) children.size() - 1; i >= 0; i--) {
+          if (poll_fds[i].revents == 0) continue;
+          char buffer[4096];
+          const ssize_t count = read(children[i].fd, buffer, sizeof(buffer));
+          if (count > 0) {
+            children[i].received.append(buffer, (size_t) count);
+            continue;
+          }
+          if (count < 0 && errno == EINTR) continue;
+          all_ok = Finish(children[i], on_result) && all_ok;
+          children.erase(children.begin() + i);
+        }
+      }
+      return all_ok;
+    }
+};
+
+#endif
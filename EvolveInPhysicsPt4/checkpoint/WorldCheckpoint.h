@@ -0,0 +1,57 @@
+/*
+  checkpoint/WorldCheckpoint.h
+    SaveCheckpoint / LoadCheckpoint write a Pt4 world (update count, random number generator
+    and everything its PopulationManager_SimplePhysics holds) to a checkpoint file and read
+    it back.
+
+    LoadCheckpoint expects a freshly built world (population manager Setup, but not yet
+    configured or populated); the world's settings come from the checkpoint, not the config.
+
+    Resuming is NOT bit-exact. Empirical's Body2D keeps a little state of its own that cannot
+    be read back out (the shift it has built up toward the next update, and the order bodies
+    were linked in), so a resumed run matches an uninterrupted one statistically rather than
+    bit for bit. Drivers that save checkpoints should say so when they do (ReportCheckpoint).
+*/
+
+#ifndef WORLD_CHECKPOINT_H
+#define WORLD_CHECKPOINT_H
+
+#include <iostream>
+#include <string>
+
+#include "../../shared/checkpoint/CheckpointFile.h"
+
+// Bump whenever the payload layout changes.
+constexpr uint32_t PT4_CHECKPOINT_VERSION = 1;
+
+template <typename WORLD>
+bool SaveCheckpoint(WORLD &world, const std::string &filename) {
+  ByteWriter writer;
+  writer.Write((int) world.update);
+  WriteRandom(writer, world.GetRandom());
+  world.popM.SaveState(writer);
+  return WriteCheckpointFile(filename, CHECKPOINT_KIND::PT4, PT4_CHECKPOINT_VERSION, writer.GetBuffer());
+}
+
+// Tell the user a checkpoint was saved, and what resuming from it will (not) reproduce.
+template <typename WORLD>
+void ReportCheckpoint(const WORLD &world, const std::string &filename) {
+  std::cout << "Saved checkpoint " << filename << " at update " << world.update
+            << " (resuming from it is not bit-exact: body shift and link order are not saved)" << std::endl;
+}
+
+template <typename WORLD>
+bool LoadCheckpoint(WORLD &world, const std::string &filename) {
+  MappedCheckpoint checkpoint(filename, CHECKPOINT_KIND::PT4, PT4_CHECKPOINT_VERSION);
+  if (!checkpoint.IsOK()) return false;
+  ByteReader reader = checkpoint.GetReader();
+  const int update = reader.Read<int>();
+  if (!ReadRandom(reader, world.GetRandom()) || !world.popM.LoadState(reader) || !reader.AtEnd()) {
+    std::cerr << "Could not load checkpoint " << filename << ": payload does not match this version" << std::endl;
+    return false;
+  }
+  world.update = update;
+  return true;
+}
+
+#endif
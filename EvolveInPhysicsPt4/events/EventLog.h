@@ -0,0 +1,135 @@
+/*
+  events/EventLog.h
+    Defines EventLog, which records what happens to a Pt4 population, update by update,
+    without recording where anything is: a run is deterministic given its seed, so the
+    discrete events are all it takes to rebuild who was alive (and who their ancestors were)
+    at any update (see events/EventReplay.h).
+
+    Hand an EventLog to PopulationManager_SimplePhysics::SetEventLog; from then on every
+    Update logs:
+      * Resources that are removed (their body was destroyed), consumed (and by which
+        organism) or too old, then the ones that flow in (and their value).
+      * Organisms that popped, offspring born (parent, offspring, cost to the parent and the
+        sites that mutated), then organisms culled to make room.
+    Entities are named by entity ID. Events go into one block per update; every
+    keyframe_interval updates (and when the log is attached) a keyframe with every living
+    organism and resource follows, so a replay never has to start far back.
+
+    File: EVENT_LOG_MAGIC and a version, then blocks of
+      uint8 kind (EVENTS or KEYFRAME), uint32 update, uint32 payload size, payload.
+    Organisms or resources added between updates (other than through Update) are not logged.
+*/
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../../shared/serialize/Bytes.h"
+
+#include "tools/BitVector.h"
+#include "tools/vector.h"
+
+enum class LOG_BLOCK : uint8_t { EVENTS = 1, KEYFRAME = 2 };
+enum class LOG_EVENT : uint8_t { RESOURCE_REMOVED = 1, RESOURCE_CONSUMED, RESOURCE_AGED, RESOURCE_SPAWNED,
+                                 ORG_POPPED, ORG_BORN, ORG_CULLED };
+
+constexpr char EVENT_LOG_MAGIC[8] = { 'E', 'M', 'P', 'E', 'V', 'L', 'O', 'G' };
+constexpr uint32_t EVENT_LOG_VERSION = 1;
+
+class EventLog {
+  private:
+    std::string filename;
+    std::ofstream file;
+    int keyframe_interval;
+    ByteWriter events;      // This update's events so far.
+    emp::vector<uint32_t> sites;  // Scratch for mutated sites.
+    int num_events;
+    uint64_t num_bytes;
+
+    void WriteBlock(LOG_BLOCK kind, uint32_t update, const std::string &payload) {
+      const uint8_t kind_byte = (uint8_t) kind;
+      const uint32_t payload_size = (uint32_t) payload.size();
+      file.write(reinterpret_cast<const char *>(&kind_byte), sizeof(kind_byte));
+      file.write(reinterpret_cast<const char *>(&update), sizeof(update));
+      file.write(reinterpret_cast<const char *>(&payload_size), sizeof(payload_size));
+      file.write(payload.data(), payload.size());
+      num_bytes += sizeof(kind_byte) + sizeof(update) + sizeof(payload_size) + payload.size();
+    }
+
+    void Add(LOG_EVENT type, uint32_t id) {
+      events.Write((uint8_t) type).Write(id);
+      num_events++;
+    }
+
+  public:
+    // Log to filename (replacing it), with a keyframe every keyframe_interval updates (0 for
+    // only the first one).
+    EventLog(const std::string &_filename, int _keyframe_interval)
+      : filename(_filename), file(_filename, std::ios::binary | std::ios::trunc),
+        keyframe_interval(_keyframe_interval), num_events(0), num_bytes(0)
+    {
+      if (!file) {
+        std::cerr << "Could not open event log " << filename << " for writing." << std::endl;
+        return;
+      }
+      file.write(EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+      file.write(reinterpret_cast<const char *>(&EVENT_LOG_VERSION), sizeof(EVENT_LOG_VERSION));
+      num_bytes = sizeof(EVENT_LOG_MAGIC) + sizeof(EVENT_LOG_VERSION);
+    }
+    EventLog(const EventLog &) = delete;
+    EventLog & operator=(const EventLog &) = delete;
+
+    bool IsOK() const { return (bool) file; }
+    int GetNumEvents() const { return num_events; }
+    uint64_t GetNumBytes() const { return num_bytes; }
+    void Flush() { file.flush(); }
+
+    void ResourceRemoved(uint32_t res_id) { Add(LOG_EVENT::RESOURCE_REMOVED, res_id); }
+    void ResourceConsumed(uint32_t res_id, uint32_t org_id) { Add(LOG_EVENT::RESOURCE_CONSUMED, res_id); events.Write(org_id); }
+    void ResourceAged(uint32_t res_id) { Add(LOG_EVENT::RESOURCE_AGED, res_id); }
+    void ResourceSpawned(uint32_t res_id, double value) { Add(LOG_EVENT::RESOURCE_SPAWNED, res_id); events.Write(value); }
+    void OrgPopped(uint32_t org_id) { Add(LOG_EVENT::ORG_POPPED, org_id); }
+    void OrgCulled(uint32_t org_id) { Add(LOG_EVENT::ORG_CULLED, org_id); }
+
+    // The offspring's genome is the parent's with the listed sites flipped.
+    void OrgBorn(uint32_t parent_id, uint32_t offspring_id, double cost,
+                 const emp::BitVector &parent_genome, const emp::BitVector &offspring_genome) {
+      sites.resize(0);
+      for (int i = 0; i < offspring_genome.GetSize(); i++) {
+        if (parent_genome.Get(i) != offspring_genome.Get(i)) sites.push_back((uint32_t) i);
+      }
+      Add(LOG_EVENT::ORG_BORN, offspring_id);
+      events.Write(parent_id).Write(cost).Write((uint32_t) sites.size());
+      if (sites.size() > 0) events.WriteBytes(sites.data(), sites.size() * sizeof(uint32_t));
+    }
+
+    // Every organism (entity ID, genome, energy, resources collected, offspring count) and
+    // resource (entity ID, value) alive after update.
+    template <typename ORG, typename RESOURCE>
+    void WriteKeyframe(uint32_t update, const emp::vector<ORG *> &population, const emp::vector<RESOURCE *> &resources) {
+      ByteWriter keyframe;
+      keyframe.Write((uint32_t) population.size());
+      for (auto *org : population) {
+        keyframe.Write(org->GetEntityID()).Write(org->genome);
+        keyframe.Write(org->GetEnergy()).Write(org->GetResourcesCollected()).Write(org->GetOffspringCount());
+      }
+      keyframe.Write((uint32_t) resources.size());
+      for (auto *res : resources) keyframe.Write(res->GetEntityID()).Write(res->GetValue());
+      WriteBlock(LOG_BLOCK::KEYFRAME, update, keyframe.GetBuffer());
+    }
+
+    // Write out update's events (and a keyframe, if one is due).
+    template <typename ORG, typename RESOURCE>
+    void EndUpdate(uint32_t update, const emp::vector<ORG *> &population, const emp::vector<RESOURCE *> &resources) {
+      WriteBlock(LOG_BLOCK::EVENTS, update, events.GetBuffer());
+      events.Clear();
+      if (keyframe_interval > 0 && update % keyframe_interval == 0) WriteKeyframe(update, population, resources);
+    }
+};
+
+#endif
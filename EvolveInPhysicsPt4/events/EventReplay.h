@@ -0,0 +1,318 @@
+/*
+  events/EventReplay.h
+    Defines EventReplay, which reads an event log (see events/EventLog.h) and rebuilds the
+    population at any logged update without running any physics.
+
+    * GetState(update, state) starts from the last keyframe at or before update and applies
+      the events logged since: who is alive (genome, energy, resources collected, offspring
+      count, parent and birth update) and which resources are out there (and their value).
+    * The genealogy is built when the log is opened: one record per organism ever seen
+      (parent, birth and death update, how it died, which sites mutated at birth).
+      GetLineage walks an organism's ancestors, GetGenome rebuilds any organism's genome
+      (living or dead) from its oldest logged ancestor, and GetCommonAncestor finds the most
+      recent common ancestor of a population.
+    Organisms already alive when logging started are the roots (parent 0).
+    Problems reading the log print a message; check IsOK().
+*/
+
+#ifndef EVENT_REPLAY_H
+#define EVENT_REPLAY_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "EventLog.h"
+
+#include "tools/BitVector.h"
+#include "tools/vector.h"
+
+struct ReplayOrganism {
+  uint32_t id;
+  uint32_t parent_id;       // 0 if alive when logging started.
+  int birth_update;
+  emp::BitVector genome;
+  double energy;
+  int resources_collected;
+  int offspring_count;
+
+  ReplayOrganism() : id(0), parent_id(0), birth_update(0), genome(0), energy(0.0), resources_collected(0), offspring_count(0) { ; }
+};
+
+struct ReplayState {
+  int update;
+  std::map<uint32_t, ReplayOrganism> organisms;   // By entity ID (so in order of birth).
+  std::map<uint32_t, double> resources;           // Entity ID -> value.
+};
+
+struct LineageRecord {
+  uint32_t id;
+  uint32_t parent_id;       // 0 for roots.
+  int birth_update;         // For roots: when logging started.
+  int death_update;         // -1 if still alive at the end of the log.
+  LOG_EVENT death_cause;    // ORG_POPPED or ORG_CULLED (if dead).
+  emp::vector<uint32_t> mutations;   // Sites flipped relative to the parent.
+};
+
+class EventReplay {
+  private:
+    struct Block {
+      LOG_BLOCK kind;
+      int update;
+      size_t offset;
+      uint32_t size;
+    };
+
+    struct Event {
+      LOG_EVENT type;
+      uint32_t id;              // Resource or organism the event is about.
+      uint32_t other_id;        // Consumer (RESOURCE_CONSUMED) or parent (ORG_BORN).
+      double value;             // Resource value (RESOURCE_SPAWNED) or cost (ORG_BORN).
+      emp::vector<uint32_t> sites;
+    };
+
+    std::string data;
+    emp::vector<Block> blocks;
+    std::unordered_map<uint32_t, LineageRecord> records;
+    std::unordered_map<uint32_t, emp::BitVector> root_genomes;
+    bool ok;
+
+    bool Fail(const std::string &filename, const std::string &what) {
+      std::cerr << "Could not read event log " << filename << ": " << what << std::endl;
+      return ok = false;
+    }
+
+    ByteReader GetReader(const Block &block) const { return ByteReader(data.data() + block.offset, block.size); }
+
+    static bool ReadEvent(ByteReader &reader, Event &event) {
+      event.type = (LOG_EVENT) reader.Read<uint8_t>();
+      event.id = reader.Read<uint32_t>();
+      event.sites.resize(0);
+      switch (event.type) {
+        case LOG_EVENT::RESOURCE_CONSUMED: event.other_id = reader.Read<uint32_t>(); break;
+        case LOG_EVENT::RESOURCE_SPAWNED: event.value = reader.Read<double>(); break;
+        case LOG_EVENT::ORG_BORN: {
+          event.other_id = reader.Read<uint32_t>();
+          event.value = reader.Read<double>();
+          const uint32_t num_sites = reader.Read<uint32_t>();
+          for (uint32_t i = 0; i < num_sites && reader.IsOK(); i++) event.sites.push_back(reader.Read<uint32_t>());
+          break;
+        }
+        default: break;
+      }
+      return reader.IsOK();
+    }
+
+    // Fill in state's organisms and resources from a keyframe block.
+    void ReadKeyframe(const Block &block, ReplayState &state) const {
+      ByteReader reader = GetReader(block);
+      state.update = block.update;
+      state.organisms.clear();
+      state.resources.clear();
+      const uint32_t num_orgs = reader.Read<uint32_t>();
+      for (uint32_t i = 0; i < num_orgs && reader.IsOK(); i++) {
+        ReplayOrganism org;
+        org.id = reader.Read<uint32_t>();
+        reader.Read(org.genome);
+        org.energy = reader.Read<double>();
+        org.resources_collected = reader.Read<int>();
+        org.offspring_count = reader.Read<int>();
+        const LineageRecord *record = GetRecord(org.id);
+        if (record != nullptr) {
+          org.parent_id = record->parent_id;
+          org.birth_update = record->birth_update;
+        }
+        state.organisms[org.id] = org;
+      }
+      const uint32_t num_resources = reader.Read<uint32_t>();
+      for (uint32_t i = 0; i < num_resources && reader.IsOK(); i++) {
+        const uint32_t res_id = reader.Read<uint32_t>();
+        state.resources[res_id] = reader.Read<double>();
+      }
+    }
+
+    void ApplyEvent(const Event &event, int update, ReplayState &state) const {
+      switch (event.type) {
+        case LOG_EVENT::RESOURCE_REMOVED:
+        case LOG_EVENT::RESOURCE_AGED:
+          state.resources.erase(event.id);
+          break;
+        case LOG_EVENT::RESOURCE_CONSUMED: {
+          auto consumer = state.organisms.find(event.other_id);
+          if (consumer != state.organisms.end()) {
+            consumer->second.energy += state.resources[event.id];
+            consumer->second.resources_collected++;
+          }
+          state.resources.erase(event.id);
+          break;
+        }
+        case LOG_EVENT::RESOURCE_SPAWNED:
+          state.resources[event.id] = event.value;
+          break;
+        case LOG_EVENT::ORG_POPPED:
+        case LOG_EVENT::ORG_CULLED:
+          state.organisms.erase(event.id);
+          break;
+        case LOG_EVENT::ORG_BORN: {
+          ReplayOrganism offspring;
+          offspring.id = event.id;
+          offspring.parent_id = event.other_id;
+          offspring.birth_update = update;
+          auto parent = state.organisms.find(event.other_id);
+          if (parent != state.organisms.end()) {
+            parent->second.energy -= event.value;
+            parent->second.offspring_count++;
+            offspring.genome = parent->second.genome;
+            for (uint32_t site : event.sites) offspring.genome[(int) site] = !offspring.genome[(int) site];
+          } else {
+            offspring.genome = GetGenome(event.id);
+          }
+          state.organisms[offspring.id] = offspring;
+          break;
+        }
+      }
+    }
+
+    void AddRoot(uint32_t id, int update, const emp::BitVector &genome) {
+      if (records.count(id) > 0) return;
+      records[id] = { id, 0, update, -1, LOG_EVENT::ORG_POPPED, emp::vector<uint32_t>() };
+      root_genomes[id] = genome;
+    }
+
+    // One pass over the whole log: who was born to whom, and when everyone died.
+    void BuildGenealogy() {
+      Event event;
+      for (const Block &block : blocks) {
+        if (block.kind == LOG_BLOCK::KEYFRAME) {
+          // Anyone in a keyframe that we have not seen born is a root.
+          ReplayState keyframe;
+          ReadKeyframe(block, keyframe);
+          for (const auto &org : keyframe.organisms) AddRoot(org.first, block.update, org.second.genome);
+          continue;
+        }
+        ByteReader reader = GetReader(block);
+        while (!reader.AtEnd() && ReadEvent(reader, event)) {
+          if (event.type == LOG_EVENT::ORG_BORN) {
+            records[event.id] = { event.id, event.other_id, block.update, -1, LOG_EVENT::ORG_POPPED, event.sites };
+          } else if (event.type == LOG_EVENT::ORG_POPPED || event.type == LOG_EVENT::ORG_CULLED) {
+            auto record = records.find(event.id);
+            if (record == records.end()) continue;
+            record->second.death_update = block.update;
+            record->second.death_cause = event.type;
+          }
+        }
+      }
+    }
+
+  public:
+    EventReplay(const std::string &filename) : ok(true) {
+      std::ifstream file(filename, std::ios::binary);
+      if (!file) { Fail(filename, "could not open"); return; }
+      std::stringstream contents;
+      contents << file.rdbuf();
+      data = contents.str();
+      uint32_t version = 0;
+      if (data.size() < sizeof(EVENT_LOG_MAGIC) + sizeof(version)
+          || std::memcmp(data.data(), EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC)) != 0) {
+        Fail(filename, "not an event log");
+        return;
+      }
+      std::memcpy(&version, data.data() + sizeof(EVENT_LOG_MAGIC), sizeof(version));
+      if (version != EVENT_LOG_VERSION) { Fail(filename, "unsupported version " + std::to_string(version)); return; }
+      // Index the blocks (a partial block at the end, e.g. from a crash, is ignored).
+      size_t pos = sizeof(EVENT_LOG_MAGIC) + sizeof(version);
+      const size_t block_header_size = sizeof(uint8_t) + 2 * sizeof(uint32_t);
+      while (pos + block_header_size <= data.size()) {
+        Block block;
+        uint32_t update;
+        block.kind = (LOG_BLOCK) data[pos];
+        std::memcpy(&update, data.data() + pos + 1, sizeof(update));
+        std::memcpy(&block.size, data.data() + pos + 1 + sizeof(update), sizeof(block.size));
+        block.update = (int) update;
+        block.offset = pos + block_header_size;
+        if (block.offset + block.size > data.size()) break;
+        blocks.push_back(block);
+        pos = block.offset + block.size;
+      }
+      if (blocks.size() == 0 || blocks[0].kind != LOG_BLOCK::KEYFRAME) { Fail(filename, "log does not start with a keyframe"); return; }
+      BuildGenealogy();
+    }
+
+    bool IsOK() const { return ok; }
+    int GetFirstUpdate() const { return blocks.size() > 0 ? blocks.front().update : 0; }
+    int GetLastUpdate() const { return blocks.size() > 0 ? blocks.back().update : 0; }
+    int GetNumRecords() const { return (int) records.size(); }
+
+    // Rebuild the population as it was after update. False if update was not logged.
+    bool GetState(int update, ReplayState &state) const {
+      if (!ok || update < GetFirstUpdate() || update > GetLastUpdate()) {
+        std::cerr << "Update " << update << " is not in the event log (" << GetFirstUpdate() << " to "
+                  << GetLastUpdate() << ")." << std::endl;
+        return false;
+      }
+      // Find the last keyframe at or before update.
+      int start = 0;
+      for (int i = 0; i < (int) blocks.size() && blocks[i].update <= update; i++) {
+        if (blocks[i].kind == LOG_BLOCK::KEYFRAME) start = i;
+      }
+      ReadKeyframe(blocks[start], state);
+      Event event;
+      for (int i = start + 1; i < (int) blocks.size() && blocks[i].update <= update; i++) {
+        if (blocks[i].kind != LOG_BLOCK::EVENTS) continue;
+        ByteReader reader = GetReader(blocks[i]);
+        while (!reader.AtEnd() && ReadEvent(reader, event)) ApplyEvent(event, blocks[i].update, state);
+      }
+      state.update = update;
+      return true;
+    }
+
+    // Null if the organism was never logged.
+    const LineageRecord * GetRecord(uint32_t id) const {
+      auto record = records.find(id);
+      return (record == records.end()) ? nullptr : &record->second;
+    }
+
+    // id, its parent, its grandparent, ... back to a root.
+    emp::vector<uint32_t> GetLineage(uint32_t id) const {
+      emp::vector<uint32_t> lineage;
+      for (const LineageRecord *record = GetRecord(id); record != nullptr; record = GetRecord(record->parent_id)) {
+        lineage.push_back(record->id);
+        if (record->parent_id == 0) break;
+      }
+      return lineage;
+    }
+
+    // The genome the organism was born with (empty if it was never logged).
+    emp::BitVector GetGenome(uint32_t id) const {
+      const emp::vector<uint32_t> lineage = GetLineage(id);
+      if (lineage.size() == 0) return emp::BitVector(0);
+      auto root = root_genomes.find(lineage.back());
+      if (root == root_genomes.end()) return emp::BitVector(0);
+      emp::BitVector genome = root->second;
+      for (int i = (int) lineage.size() - 2; i >= 0; i--) {
+        for (uint32_t site : GetRecord(lineage[i])->mutations) genome[(int) site] = !genome[(int) site];
+      }
+      return genome;
+    }
+
+    // The most recent organism every member of state descends from (0 if they have no common
+    // ancestor, or state is empty).
+    uint32_t GetCommonAncestor(const ReplayState &state) const {
+      if (state.organisms.size() == 0) return 0;
+      std::unordered_map<uint32_t, int> descendant_counts;
+      for (const auto &org : state.organisms) {
+        for (uint32_t ancestor : GetLineage(org.first)) descendant_counts[ancestor]++;
+      }
+      for (uint32_t ancestor : GetLineage(state.organisms.begin()->first)) {
+        if (descendant_counts[ancestor] == (int) state.organisms.size()) return ancestor;
+      }
+      return 0;
+    }
+};
+
+#endif
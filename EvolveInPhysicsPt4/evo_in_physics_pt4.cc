@@ -0,0 +1,113 @@
+/*
+  evo_in_physics_pt4.cc
+
+  Headless native driver for the Pt4 experiment.
+    * Builds the same world as evo_in_physics_pt4_web.cc (one randomized ancestor in the
+      middle of the world), without drawing anything.
+    * Parameters come from evo-in-physics-pt4.cfg and/or the command line.
+    * If CHECKPOINT_FILE is set and exists, the run picks up from it instead (and runs
+      UPDATES more updates); a checkpoint is saved there every CHECKPOINT_INTERVAL updates
+      and at the end (see checkpoint/WorldCheckpoint.h). Resuming from one is not bit-exact,
+      and each save says so.
+    * If EVENT_LOG_FILE is set, births, deaths and resource events are logged there, with a
+      keyframe every KEYFRAME_INTERVAL updates (see events/EventLog.h;
+      evo_in_physics_pt4_replay reads it back).
+    * If STATS_FILE is set, population stats are written there every RESOLUTION updates (see
+      StatsConfig.cfg), by a background thread (see shared/stats/StatsWriter.h).
+    * Runs UPDATES updates as fast as possible and reports updates/sec and bodies/sec
+      (bodies = organisms + resources, summed over updates).
+*/
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+#include "config/ArgManager.h"
+
+#include "evo_in_physics_pt4_config.h"
+#include "./checkpoint/WorldCheckpoint.h"
+#include "./events/EventLog.h"
+#include "../shared/stats/StatsWriter.h"
+#include "./stats/PopulationStats.h"
+
+int main(int argc, char *argv[]) {
+  // Load config.
+  EvoInPhysicsPt4Config config;
+  std::string config_filename = "evo-in-physics-pt4.cfg";
+  config.Read(config_filename);
+  auto args = emp::cl::ArgManager(argc, argv);
+  if (!args.ProcessConfigOptions(config, std::cout, config_filename)) return 0;
+
+  // Build the world.
+  const Pt4Params params(config);
+  emp::Random random(params.random_seed);
+  SimplePhysicsWorld world(random, "simple-world");
+  const std::string checkpoint_file = config.CHECKPOINT_FILE();
+  if (checkpoint_file != "" && std::ifstream(checkpoint_file)) {
+    world.popM.SetNumThreads(params.num_threads);
+    if (!LoadCheckpoint(world, checkpoint_file)) return 1;
+    std::cout << "Resumed from " << checkpoint_file << " at update " << world.update << std::endl;
+  } else {
+    ConfigWorld(world, params);
+    InsertAncestor(world, params, random);
+  }
+  std::unique_ptr<EventLog> event_log;
+  if (config.EVENT_LOG_FILE() != "") {
+    event_log.reset(new EventLog(config.EVENT_LOG_FILE(), config.KEYFRAME_INTERVAL()));
+    if (!event_log->IsOK()) return 1;
+    world.popM.SetEventLog(event_log.get());
+  }
+  std::unique_ptr<StatsWriter> stats;
+  if (config.STATS_FILE() != "") {
+    StatsConfig stats_config;
+    stats_config.Read("StatsConfig.cfg");
+    stats.reset(new StatsWriter(stats_config, PopulationStats::GetNames(), config.STATS_FILE()));
+  }
+  PopulationStats pop_stats;
+
+  // Run!
+  const int updates = config.UPDATES();
+  const int report_interval = config.REPORT_INTERVAL();
+  const int checkpoint_interval = config.CHECKPOINT_INTERVAL();
+  double body_updates = 0.0;
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int ud = 0; ud < updates; ud++) {
+    world.Update();
+    body_updates += world.popM.GetSize() + world.popM.GetNumResources();
+    if (report_interval > 0 && world.update % report_interval == 0) {
+      std::cout << "Update: " << world.update << " Organisms: " << world.popM.GetSize()
+                << " Resources: " << world.popM.GetNumResources() << "\n";
+    }
+    if (stats && stats->IsSampleUpdate(world.update)) {
+      pop_stats.Sample(world.popM, &world.popM.GetThreadPool());
+      stats->Begin(world.update);
+      for (double value : pop_stats.GetValues()) stats->Add(value);
+      stats->Push();
+    }
+    if (checkpoint_file != "" && checkpoint_interval > 0 && world.update % checkpoint_interval == 0) {
+      if (event_log) event_log->Flush();
+      if (stats) stats->Flush();
+      if (!SaveCheckpoint(world, checkpoint_file)) return 1;
+      ReportCheckpoint(world, checkpoint_file);
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  const double seconds = elapsed.count();
+  if (stats) stats->Close();
+  if (checkpoint_file != "") {
+    if (!SaveCheckpoint(world, checkpoint_file)) return 1;
+    ReportCheckpoint(world, checkpoint_file);
+  }
+  std::cout << "Ran " << updates << " updates in " << seconds << " seconds: "
+            << (seconds > 0.0 ? updates / seconds : 0.0) << " updates/sec, "
+            << (seconds > 0.0 ? body_updates / seconds : 0.0) << " bodies/sec" << std::endl;
+  if (event_log) {
+    world.popM.SetEventLog(nullptr);
+    event_log->Flush();
+    std::cout << "Logged " << event_log->GetNumEvents() << " events (" << event_log->GetNumBytes() << " bytes) to "
+              << config.EVENT_LOG_FILE() << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+  evo_in_physics_pt4_branch.cc
+
+  What-if runs from the middle of a Pt4 experiment (see branching/ForkBrancher.h).
+    * The trunk is built from evo-in-physics-pt4.cfg and/or the command line and run for
+      BRANCH_AT updates, or picked up from CHECKPOINT_FILE if that is set and exists.
+    * BRANCH_FILE lists the settings to change (in sweep file format, see
+      sweep/SweepSpec.h); every combination is run BRANCH_REPLICATES times. Only settings
+      that can change mid-run are allowed (not the world size, friction, genome length or
+      anything fixed when an organism is born).
+    * Each branch is a fork of the trunk: it takes its settings, reseeds with its
+      RANDOM_SEED + replicate number, runs BRANCH_UPDATES more updates (on NUM_THREADS
+      threads) and reports back. BRANCH_PROCESSES branches run at once.
+    * One row per branch goes to BRANCH_RESULTS_FILE as soon as the branch is done.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "config/ArgManager.h"
+
+#include "evo_in_physics_pt4_config.h"
+#include "./checkpoint/WorldCheckpoint.h"
+#include "./sweep/SweepSpec.h"
+#include "./branching/ForkBrancher.h"
+
+// Can this setting be changed in a world that is already running?
+bool IsBranchSetting(const std::string &name) {
+  return name == "RANDOM_SEED" || name == "MAX_POP_SIZE" || name == "POINT_MUTATION_RATE"
+         || name == "COST_OF_REPRO" || name == "MAX_RESOURCE_AGE" || name == "MAX_RESOURCE_COUNT"
+         || name == "RESOURCE_RADIUS" || name == "RESOURCE_VALUE" || name == "RESOURCE_IN_FLOW"
+         || name == "MOVEMENT_NOISE";
+}
+
+// Runs in the branch's own process.
+ForkBrancher::row_t RunBranch(SimplePhysicsWorld &world, const Pt4Params &params, int replicate, int updates) {
+  const auto start_time = std::chrono::steady_clock::now();
+  const int seed = params.random_seed + replicate;
+  world.GetRandom().ResetSeed(seed);
+  world.popM.SetRandomSeed((uint32_t) seed);
+  ReconfigWorld(world, params);
+
+  double total_organisms = 0.0;
+  int steps = 0;
+  for (int ud = 0; ud < updates && world.popM.GetSize() > 0; ud++) {
+    world.Update();
+    total_organisms += world.popM.GetSize();
+    steps++;
+  }
+
+  double total_energy = 0.0;
+  double total_ones = 0.0;
+  const int organisms = world.popM.GetSize();
+  for (int i = 0; i < organisms; i++) {
+    total_energy += world.popM[i]->GetEnergy();
+    total_ones += world.popM[i]->genome.CountOnes();
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  return { (double) seed, (double) world.update, (double) organisms, (double) world.popM.GetNumResources(),
+           (steps > 0) ? total_organisms / steps : (double) organisms,
+           (organisms > 0) ? total_energy / organisms : 0.0,
+           (organisms > 0) ? total_ones / organisms : 0.0,
+           elapsed.count() };
+}
+
+int main(int argc, char *argv[]) {
+  // Load config.
+  EvoInPhysicsPt4Config config;
+  std::string config_filename = "evo-in-physics-pt4.cfg";
+  config.Read(config_filename);
+  auto args = emp::cl::ArgManager(argc, argv);
+  if (!args.ProcessConfigOptions(config, std::cout, config_filename)) return 0;
+
+  // Work out the branches.
+  SweepSpec spec;
+  if (!spec.Read(config.BRANCH_FILE())) return 1;
+  emp::vector<std::string> point_names;
+  for (int s = 0; s < spec.GetNumSettings(); s++) {
+    if (!IsBranchSetting(spec.GetName(s))) {
+      std::cerr << "Setting cannot be changed in a running world: " << spec.GetName(s) << std::endl;
+      return 1;
+    }
+    point_names.push_back(spec.GetName(s));
+  }
+  const Pt4Params base_params(config);
+  const emp::vector<SweepSpec::point_t> points = spec.GetGridPoints();
+  emp::vector<Pt4Params> point_params(points.size(), base_params);
+  for (int p = 0; p < (int) points.size(); p++) {
+    for (int s = 0; s < (int) point_names.size(); s++) point_params[p].Set(point_names[s], points[p][s]);
+  }
+  const int replicates = std::max(1, config.BRANCH_REPLICATES());
+  const int num_branches = (int) points.size() * replicates;
+
+  std::ofstream results_file(config.BRANCH_RESULTS_FILE());
+  if (!results_file) {
+    std::cerr << "Could not open " << config.BRANCH_RESULTS_FILE() << " for writing." << std::endl;
+    return 1;
+  }
+
+  // Grow the trunk (single-threaded from here on, so it can be forked).
+  emp::Random random(base_params.random_seed);
+  SimplePhysicsWorld world(random, "trunk-world");
+  const std::string checkpoint_file = config.CHECKPOINT_FILE();
+  if (checkpoint_file != "" && std::ifstream(checkpoint_file)) {
+    world.popM.SetNumThreads(base_params.num_threads);
+    if (!LoadCheckpoint(world, checkpoint_file)) return 1;
+  } else {
+    ConfigWorld(world, base_params);
+    InsertAncestor(world, base_params, random);
+    for (int ud = 0; ud < config.BRANCH_AT(); ud++) world.Update();
+  }
+  world.popM.SetNumThreads(1);
+  std::cout << "Branching " << num_branches << " ways at update " << world.update << " (" << world.popM.GetSize()
+            << " organisms, " << world.popM.GetNumResources() << " resources)" << std::endl;
+
+  // Branch!
+  results_file << "branch_id" << "," << "replicate";
+  for (const auto &name : point_names) results_file << "," << name;
+  results_file << ",seed,updates,organisms,resources,mean_organisms,mean_energy,mean_ones,seconds" << std::endl;
+  int num_processes = config.BRANCH_PROCESSES();
+  if (num_processes <= 0) num_processes = std::max(1, (int) std::thread::hardware_concurrency());
+  ForkBrancher brancher(num_processes);
+  const int branch_updates = config.BRANCH_UPDATES();
+  const auto start_time = std::chrono::steady_clock::now();
+  const bool ok = brancher.Run(num_branches,
+    [&world, &point_params, replicates, branch_updates](int branch_id) {
+      return RunBranch(world, point_params[branch_id / replicates], branch_id % replicates, branch_updates);
+    },
+    [&results_file, &points, replicates](int branch_id, const ForkBrancher::row_t &row) {
+      results_file << branch_id << "," << branch_id % replicates;
+      for (double value : points[branch_id / replicates]) results_file << "," << value;
+      for (double value : row) results_file << "," << value;
+      results_file << "\n";
+      results_file.flush();
+    });
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+  std::cout << "Ran " << num_branches << " branches, " << brancher.GetMaxChildren() << " at a time, in "
+            << elapsed.count() << " seconds (" << brancher.GetMeanForkSeconds() * 1000.0
+            << " ms per branch to fork)." << std::endl;
+  return ok ? 0 : 1;
+}
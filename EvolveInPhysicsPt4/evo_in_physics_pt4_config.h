@@ -0,0 +1,177 @@
+/*
+  evo_in_physics_pt4_config.h
+    Configuration shared by the native Pt4 drivers (evo_in_physics_pt4.cc,
+    evo_in_physics_pt4_replicates.cc, evo_in_physics_pt4_sweep.cc,
+    evo_in_physics_pt4_branch.cc), along with the helpers that turn it into a world:
+    Pt4Params holds the DEFAULT group (and NUM_THREADS) as plain values, ConfigWorld passes
+    them to the population manager (ReconfigWorld passes the ones that may change mid-run),
+    and InsertAncestor adds the single randomized ancestor every run starts from.
+*/
+
+#ifndef EVO_IN_PHYSICS_PT4_CONFIG_H
+#define EVO_IN_PHYSICS_PT4_CONFIG_H
+
+#include <string>
+#include <cmath>
+
+#include "./organisms/SimpleOrganism.h"
+#include "./resources/SimpleResource.h"
+#include "./population-managers/PopulationManager_SimplePhysics.h"
+
+#include "config/config.h"
+
+#include "tools/Random.h"
+
+#include "evo/World.h"
+
+EMP_BUILD_CONFIG(EvoInPhysicsPt4Config,
+  GROUP(DEFAULT, "Default settings for Evo In Physics Pt 4 experiments."),
+  VALUE(RANDOM_SEED, int, 1, "Random number seed (0 for based on time)."),
+  VALUE(WORLD_WIDTH, int, 500, "Width of the physics world."),
+  VALUE(WORLD_HEIGHT, int, 500, "Height of the physics world."),
+  VALUE(MAX_POP_SIZE, int, 250, "Maximum population size allowed in the world."),
+  VALUE(GENOME_LENGTH, int, 10, "Number of sites in each organism's genome."),
+  VALUE(POINT_MUTATION_RATE, double, 0.01, "Organism per-site mutation rate."),
+  VALUE(MAX_ORGANISM_RADIUS, double, 10, "Organism radius."),
+  VALUE(COST_OF_REPRO, double, 1, "How much energy is necessary for an organism to reproduce?"),
+  VALUE(DETACH_ON_BIRTH, bool, true, "Do organisms detach from parents at birth?"),
+  VALUE(ORGANISM_MEMBRANE_STRENGTH, double, 10.0, "How much pressure an organism can take before popping."),
+  VALUE(MAX_RESOURCE_AGE, int, 10000, "Maximum number of updates that resources may persist."),
+  VALUE(MAX_RESOURCE_COUNT, int, 100, "Maximum number of resources allowed in the environment at any given time."),
+  VALUE(RESOURCE_RADIUS, double, 5.0, "Resource radius."),
+  VALUE(RESOURCE_VALUE, double, 1.0, "How much energy is each resource worth when consumed?"),
+  VALUE(RESOURCE_IN_FLOW, int, 10, "How many resources may flow in per update (up to the max count)."),
+  VALUE(SURFACE_FRICTION, double, 0.0025, "Surface friction."),
+  VALUE(MOVEMENT_NOISE, double, 0.15, "Magnitude of the random kick bodies get every update."),
+  GROUP(RUN, "Settings for headless runs."),
+  VALUE(UPDATES, int, 1000, "How many updates to run."),
+  VALUE(NUM_THREADS, int, 1, "How many threads the population manager may use."),
+  VALUE(REPORT_INTERVAL, int, 100, "Print population counts every this many updates (0 for never)."),
+  VALUE(CHECKPOINT_FILE, std::string, "", "Resume from this checkpoint if it exists, and save to it (empty for no checkpoints)."),
+  VALUE(CHECKPOINT_INTERVAL, int, 0, "Save a checkpoint every this many updates, and at the end (0 for only at the end)."),
+  VALUE(EVENT_LOG_FILE, std::string, "", "Log births, deaths and resource events here (empty for no log)."),
+  VALUE(KEYFRAME_INTERVAL, int, 100, "Write the whole population to the event log every this many updates."),
+  VALUE(STATS_FILE, std::string, "", "Write stats here every RESOLUTION updates (see StatsConfig.cfg; empty for none)."),
+  GROUP(REPLICATES, "Settings for evo_in_physics_pt4_replicates."),
+  VALUE(REPLICATES, int, 30, "How many replicates to run (seeds RANDOM_SEED, RANDOM_SEED + 1, ...)."),
+  VALUE(REPLICATE_THREADS, int, 0, "How many replicates to run at once (0 for one per core)."),
+  VALUE(REPLICATE_FILE, std::string, "replicates.csv", "Where to write one summary row per replicate."),
+  GROUP(SWEEP, "Settings for evo_in_physics_pt4_sweep."),
+  VALUE(SWEEP_FILE, std::string, "evo-in-physics-pt4.sweep", "Which settings to sweep over, and their values."),
+  VALUE(SWEEP_MODE, std::string, "grid", "grid (every combination) or random (SWEEP_SAMPLES random points)."),
+  VALUE(SWEEP_SAMPLES, int, 20, "How many points to draw in random mode."),
+  VALUE(SWEEP_REPLICATES, int, 3, "How many seeds to run each point with (RANDOM_SEED, RANDOM_SEED + 1, ...)."),
+  VALUE(SWEEP_MIN_UPDATES, int, 100, "Updates every point gets before the first cut."),
+  VALUE(SWEEP_ETA, int, 3, "Keep the best 1/SWEEP_ETA of the points at every cut, and run them SWEEP_ETA times longer."),
+  VALUE(PLATEAU_TOLERANCE, double, 0.05, "Drop points whose mean population grew by less than this fraction since the last cut."),
+  VALUE(SWEEP_THREADS, int, 0, "How many runs to advance at once (0 for one per core)."),
+  VALUE(SWEEP_RESULTS_FILE, std::string, "sweep.csv", "Where to write the results table."),
+  GROUP(BRANCH, "Settings for evo_in_physics_pt4_branch."),
+  VALUE(BRANCH_AT, int, 500, "Run this many updates before branching (unless resuming from CHECKPOINT_FILE)."),
+  VALUE(BRANCH_UPDATES, int, 500, "How many updates each branch runs on for."),
+  VALUE(BRANCH_FILE, std::string, "evo-in-physics-pt4.branches", "Which settings each branch changes, and to what (sweep file format)."),
+  VALUE(BRANCH_REPLICATES, int, 1, "How many branches to run per setting combination (reseeded RANDOM_SEED, RANDOM_SEED + 1, ...)."),
+  VALUE(BRANCH_PROCESSES, int, 0, "How many branches to run at once (0 for one per core)."),
+  VALUE(BRANCH_RESULTS_FILE, std::string, "branches.csv", "Where to write one row per branch.")
+)
+
+using Organism_t = SimpleOrganism;
+using SimplePhysicsWorld = emp::evo::World<Organism_t, emp::evo::PopulationManager_SimplePhysics<Organism_t> >;
+
+// The settings a world is built from, as plain values. Unlike the config object these can be
+// copied, so each run (on whichever thread) can have its own, tweaked copy.
+struct Pt4Params {
+  int random_seed;
+  int world_width;
+  int world_height;
+  int max_pop_size;
+  int genome_length;
+  double point_mutation_rate;
+  double max_organism_radius;
+  double cost_of_repro;
+  bool detach_on_birth;
+  double organism_membrane_strength;
+  int max_resource_age;
+  int max_resource_count;
+  double resource_radius;
+  double resource_value;
+  int resource_in_flow;
+  double surface_friction;
+  double movement_noise;
+  int num_threads;
+
+  Pt4Params(const EvoInPhysicsPt4Config &config)
+    : random_seed(config.RANDOM_SEED()), world_width(config.WORLD_WIDTH()), world_height(config.WORLD_HEIGHT()),
+      max_pop_size(config.MAX_POP_SIZE()), genome_length(config.GENOME_LENGTH()),
+      point_mutation_rate(config.POINT_MUTATION_RATE()), max_organism_radius(config.MAX_ORGANISM_RADIUS()),
+      cost_of_repro(config.COST_OF_REPRO()), detach_on_birth(config.DETACH_ON_BIRTH()),
+      organism_membrane_strength(config.ORGANISM_MEMBRANE_STRENGTH()),
+      max_resource_age(config.MAX_RESOURCE_AGE()), max_resource_count(config.MAX_RESOURCE_COUNT()),
+      resource_radius(config.RESOURCE_RADIUS()), resource_value(config.RESOURCE_VALUE()),
+      resource_in_flow(config.RESOURCE_IN_FLOW()), surface_friction(config.SURFACE_FRICTION()),
+      movement_noise(config.MOVEMENT_NOISE()), num_threads(config.NUM_THREADS())
+  { ; }
+
+  // Set a DEFAULT-group setting by its config name (integer settings are rounded). Returns
+  // false if there is no such setting.
+  bool Set(const std::string &name, double value) {
+    const int int_value = (int) std::lround(value);
+    if (name == "RANDOM_SEED") random_seed = int_value;
+    else if (name == "WORLD_WIDTH") world_width = int_value;
+    else if (name == "WORLD_HEIGHT") world_height = int_value;
+    else if (name == "MAX_POP_SIZE") max_pop_size = int_value;
+    else if (name == "GENOME_LENGTH") genome_length = int_value;
+    else if (name == "POINT_MUTATION_RATE") point_mutation_rate = value;
+    else if (name == "MAX_ORGANISM_RADIUS") max_organism_radius = value;
+    else if (name == "COST_OF_REPRO") cost_of_repro = value;
+    else if (name == "DETACH_ON_BIRTH") detach_on_birth = (int_value != 0);
+    else if (name == "ORGANISM_MEMBRANE_STRENGTH") organism_membrane_strength = value;
+    else if (name == "MAX_RESOURCE_AGE") max_resource_age = int_value;
+    else if (name == "MAX_RESOURCE_COUNT") max_resource_count = int_value;
+    else if (name == "RESOURCE_RADIUS") resource_radius = value;
+    else if (name == "RESOURCE_VALUE") resource_value = value;
+    else if (name == "RESOURCE_IN_FLOW") resource_in_flow = int_value;
+    else if (name == "SURFACE_FRICTION") surface_friction = value;
+    else if (name == "MOVEMENT_NOISE") movement_noise = value;
+    else return false;
+    return true;
+  }
+};
+
+// Hand the settings to the world's population manager.
+template <typename WORLD>
+void ConfigWorld(WORLD &world, const Pt4Params &params) {
+  world.popM.SetNumThreads(params.num_threads);
+  world.ConfigPop(params.world_width, params.world_height, params.surface_friction,
+                  params.max_pop_size, params.point_mutation_rate, params.max_organism_radius,
+                  params.cost_of_repro, params.max_resource_age, params.max_resource_count,
+                  params.resource_in_flow, params.resource_radius, params.resource_value,
+                  params.movement_noise);
+}
+
+// Hand the settings that can change mid-run to a running world's population manager (the
+// rest are fixed once the world is configured).
+template <typename WORLD>
+void ReconfigWorld(WORLD &world, const Pt4Params &params) {
+  world.popM.SetNumThreads(params.num_threads);
+  world.popM.ReconfigPop(params.max_pop_size, params.point_mutation_rate, params.cost_of_repro,
+                         params.max_resource_age, params.max_resource_count, params.resource_in_flow,
+                         params.resource_radius, params.resource_value, params.movement_noise);
+}
+
+// Initialize the population with a single, randomized ancestor in the middle of the world.
+template <typename WORLD>
+void InsertAncestor(WORLD &world, const Pt4Params &params, emp::Random &random) {
+  const emp::Point<double> mid_point(params.world_width / 2.0, params.world_height / 2.0);
+  int org_radius = params.max_organism_radius;
+  Organism_t ancestor(emp::Circle(mid_point, org_radius), params.genome_length, params.detach_on_birth);
+  for (int i = 0; i < ancestor.genome.GetSize(); i++) {
+    if (random.P(0.5)) ancestor.genome[i] = !ancestor.genome[i];
+  }
+  ancestor.GetBody().SetMass(10.0);
+  ancestor.SetMembraneStrength(params.organism_membrane_strength);
+  ancestor.SetBirthTime(-1);
+  world.Insert(ancestor);
+}
+
+#endif
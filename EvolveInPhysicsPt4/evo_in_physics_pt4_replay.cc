@@ -0,0 +1,81 @@
+/*
+  evo_in_physics_pt4_replay.cc
+
+  Reads an event log written by evo_in_physics_pt4 (EVENT_LOG_FILE) and reports on the
+  population at any logged update, without rerunning the physics (see events/EventReplay.h).
+    usage: evo_in_physics_pt4_replay log_file [update [organism_id]]
+    * Prints who was alive at update (default: the last logged update): population size,
+      resources, mean energy, the most common genome and the most recent common ancestor.
+    * Given an organism ID, also prints its lineage back to the start of the log.
+*/
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <cstdlib>
+
+#include "./events/EventReplay.h"
+
+void PrintGenome(const emp::BitVector &genome) {
+  for (int i = 0; i < genome.GetSize(); i++) std::cout << genome.Get(i);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " log_file [update [organism_id]]" << std::endl;
+    return 1;
+  }
+  EventReplay replay(argv[1]);
+  if (!replay.IsOK()) return 1;
+  const int update = (argc > 2) ? std::atoi(argv[2]) : replay.GetLastUpdate();
+  ReplayState state;
+  if (!replay.GetState(update, state)) return 1;
+
+  double total_energy = 0.0;
+  std::map<emp::BitVector, int> genome_counts;
+  for (const auto &org : state.organisms) {
+    total_energy += org.second.energy;
+    genome_counts[org.second.genome]++;
+  }
+  std::cout << "Update: " << state.update << " (log covers " << replay.GetFirstUpdate() << " to "
+            << replay.GetLastUpdate() << ", " << replay.GetNumRecords() << " organisms ever)" << std::endl;
+  std::cout << "Organisms: " << state.organisms.size() << " Resources: " << state.resources.size() << std::endl;
+  if (state.organisms.size() > 0) {
+    auto dominant = genome_counts.begin();
+    for (auto it = genome_counts.begin(); it != genome_counts.end(); ++it) {
+      if (it->second > dominant->second) dominant = it;
+    }
+    std::cout << "Mean energy: " << total_energy / state.organisms.size() << std::endl;
+    std::cout << "Genotypes: " << genome_counts.size() << " Most common: ";
+    PrintGenome(dominant->first);
+    std::cout << " (" << dominant->second << " organisms)" << std::endl;
+    const uint32_t ancestor = replay.GetCommonAncestor(state);
+    if (ancestor != 0) {
+      std::cout << "Most recent common ancestor: " << ancestor << " (born at update "
+                << replay.GetRecord(ancestor)->birth_update << ")" << std::endl;
+    } else {
+      std::cout << "No common ancestor since the log started." << std::endl;
+    }
+  }
+
+  if (argc > 3) {
+    const uint32_t org_id = (uint32_t) std::atoll(argv[3]);
+    if (replay.GetRecord(org_id) == nullptr) {
+      std::cerr << "Organism " << org_id << " is not in the log." << std::endl;
+      return 1;
+    }
+    std::cout << "Lineage of " << org_id << ":" << std::endl;
+    for (uint32_t id : replay.GetLineage(org_id)) {
+      const LineageRecord *record = replay.GetRecord(id);
+      std::cout << "  " << id << " born " << record->birth_update;
+      if (record->death_update >= 0) {
+        std::cout << ", " << (record->death_cause == LOG_EVENT::ORG_CULLED ? "culled" : "popped")
+                  << " " << record->death_update;
+      }
+      std::cout << ", genome ";
+      PrintGenome(replay.GetGenome(id));
+      std::cout << std::endl;
+    }
+  }
+  return 0;
+}
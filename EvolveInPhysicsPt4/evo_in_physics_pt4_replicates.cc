@@ -0,0 +1,88 @@
+/*
+  evo_in_physics_pt4_replicates.cc
+
+  Runs REPLICATES replicates of the Pt4 experiment in one process (see
+  replicates/ReplicateRunner.h).
+    * Every replicate gets its own world, seeded with RANDOM_SEED + replicate number, and
+      starts from its own randomized ancestor. Everything else comes from
+      evo-in-physics-pt4.cfg and/or the command line, read once and shared.
+    * REPLICATE_THREADS replicates run at a time, each on NUM_THREADS threads.
+    * Each replicate's summary goes to REPLICATE_FILE as soon as it finishes; the mean and
+      95% CI of every column over all replicates are printed at the end.
+    * A population that goes extinct stays extinct, so that replicate stops early (the
+      updates column says how far it got).
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "config/ArgManager.h"
+
+#include "evo_in_physics_pt4_config.h"
+#include "./replicates/ReplicateRunner.h"
+
+ReplicateRunner::row_t RunReplicate(const Pt4Params &params, int updates, int seed) {
+  const auto start_time = std::chrono::steady_clock::now();
+  emp::Random random(seed);
+  SimplePhysicsWorld world(random, "replicate-world");
+  ConfigWorld(world, params);
+  InsertAncestor(world, params, random);
+
+  int peak_organisms = world.popM.GetSize();
+  for (int ud = 0; ud < updates && world.popM.GetSize() > 0; ud++) {
+    world.Update();
+    peak_organisms = std::max(peak_organisms, world.popM.GetSize());
+  }
+
+  double total_energy = 0.0;
+  double total_ones = 0.0;
+  for (int i = 0; i < world.popM.GetSize(); i++) {
+    total_energy += world.popM[i]->GetEnergy();
+    total_ones += world.popM[i]->genome.CountOnes();
+  }
+  const int organisms = world.popM.GetSize();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  return { (double) world.update, (double) organisms, (double) world.popM.GetNumResources(),
+           (double) peak_organisms,
+           (organisms > 0) ? total_energy / organisms : 0.0,
+           (organisms > 0) ? total_ones / organisms : 0.0,
+           elapsed.count() };
+}
+
+int main(int argc, char *argv[]) {
+  // Load config.
+  EvoInPhysicsPt4Config config;
+  std::string config_filename = "evo-in-physics-pt4.cfg";
+  config.Read(config_filename);
+  auto args = emp::cl::ArgManager(argc, argv);
+  if (!args.ProcessConfigOptions(config, std::cout, config_filename)) return 0;
+
+  int num_threads = config.REPLICATE_THREADS();
+  if (num_threads <= 0) num_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  std::ofstream replicate_file(config.REPLICATE_FILE());
+  if (!replicate_file) {
+    std::cerr << "Could not open " << config.REPLICATE_FILE() << " for writing." << std::endl;
+    return 1;
+  }
+
+  ReplicateRunner runner({ "updates", "organisms", "resources", "peak_organisms",
+                           "mean_energy", "mean_ones", "seconds" },
+                         replicate_file, num_threads);
+  const auto start_time = std::chrono::steady_clock::now();
+  const Pt4Params params(config);
+  const int updates = config.UPDATES();
+  runner.Run(params.random_seed, config.REPLICATES(), [&params, updates](int seed) {
+    return RunReplicate(params, updates, seed);
+  });
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+  runner.PrintSummary(std::cout);
+  std::cout << "Ran " << runner.GetNumFinished() << " replicates on " << runner.GetNumThreads()
+            << " threads in " << elapsed.count() << " seconds (" << runner.GetStealCount()
+            << " stolen)." << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*
+  evo_in_physics_pt4_sharded.cc
+
+  Runs one Pt4 world split across several local processes (see
+  population-managers/PopulationManager_ShardedPhysics.h).
+    evo_in_physics_pt4_sharded [num_shards] [updates] [random_seed]
+  Everything else uses the web interface's defaults.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+
+#include "./organisms/SimpleOrganism.h"
+#include "./resources/SimpleResource.h"
+#include "./population-managers/PopulationManager_ShardedPhysics.h"
+#include "./sharding/Transport.h"
+
+#include "tools/Random.h"
+
+#include "evo/World.h"
+
+const int DEFAULT_NUM_SHARDS = 2;
+const int DEFAULT_UPDATES = 1000;
+const int DEFAULT_RANDOM_SEED = 1;
+const int DEFAULT_WORLD_WIDTH = 500;
+const int DEFAULT_WORLD_HEIGHT = 500;
+const int DEFAULT_MAX_POP_SIZE = 250;
+const int DEFAULT_GENOME_LENGTH = 10;
+const double DEFAULT_POINT_MUTATION_RATE = 0.01;
+const double DEFAULT_MAX_ORGANISM_RADIUS = 10;
+const double DEFAULT_COST_OF_REPRO = 1;
+const bool DEFAULT_DETACH_ON_BIRTH = true;
+const double DEFAULT_ORGANISM_MEMBRANE_STRENGTH = 10.0;
+const int DEFAULT_MAX_RESOURCE_AGE = 10000;
+const int DEFAULT_MAX_RESOURCE_COUNT = 100;
+const double DEFAULT_RESOURCE_RADIUS = 5.0;
+const double DEFAULT_RESOURCE_VALUE = 1.0;
+const int DEFAULT_RESOURCE_IN_FLOW = 10;
+const double DEFAULT_SURFACE_FRICTION = 0.0025;
+const double DEFAULT_MOVEMENT_NOISE = 0.15;
+
+using Organism_t = SimpleOrganism;
+using ShardedWorld = emp::evo::World<Organism_t, emp::evo::PopulationManager_ShardedPhysics<Organism_t> >;
+
+int RunShard(Transport &transport, int updates, int random_seed) {
+  // Every shard starts from the same seed (the manager splits streams by rank).
+  emp::Random random(random_seed);
+  ShardedWorld world(random, "sharded-world");
+  world.popM.SetTransport(&transport);
+  world.ConfigPop(DEFAULT_WORLD_WIDTH, DEFAULT_WORLD_HEIGHT, DEFAULT_SURFACE_FRICTION,
+                  DEFAULT_MAX_POP_SIZE, DEFAULT_POINT_MUTATION_RATE, DEFAULT_MAX_ORGANISM_RADIUS,
+                  DEFAULT_COST_OF_REPRO, DEFAULT_MAX_RESOURCE_AGE, DEFAULT_MAX_RESOURCE_COUNT,
+                  DEFAULT_RESOURCE_IN_FLOW, DEFAULT_RESOURCE_RADIUS, DEFAULT_RESOURCE_VALUE,
+                  DEFAULT_MOVEMENT_NOISE);
+  // The ancestor goes in the middle of the world (on whichever shard owns that spot).
+  const emp::Point<double> mid_point(DEFAULT_WORLD_WIDTH / 2.0, DEFAULT_WORLD_HEIGHT / 2.0);
+  Organism_t ancestor(emp::Circle(mid_point, DEFAULT_MAX_ORGANISM_RADIUS), DEFAULT_GENOME_LENGTH, DEFAULT_DETACH_ON_BIRTH);
+  for (int i = 0; i < ancestor.genome.GetSize(); i++) {
+    if (random.P(0.5)) ancestor.genome[i] = !ancestor.genome[i];
+  }
+  ancestor.GetBody().SetMass(10.0);
+  ancestor.SetMembraneStrength(DEFAULT_ORGANISM_MEMBRANE_STRENGTH);
+  ancestor.SetBirthTime(-1);
+  if (world.popM.InStripe(mid_point.GetX())) world.Insert(ancestor);
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int ud = 0; ud < updates; ud++) {
+    world.Update();
+    if (transport.GetRank() == 0 && (ud + 1) % 100 == 0) {
+      std::cout << "Update: " << world.update << " Organisms: " << world.popM.GetGlobalSize() << std::endl;
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  std::cout << "Shard " << transport.GetRank() << ": " << world.GetSize() << " organisms, "
+            << world.popM.GetNumResources() << " resources, "
+            << world.popM.GetMigratedIn() << " organisms in, " << world.popM.GetMigratedOut() << " out, "
+            << (elapsed.count() > 0.0 ? updates / elapsed.count() : 0.0) << " updates/sec" << std::endl;
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  const int num_shards = (argc > 1) ? std::atoi(argv[1]) : DEFAULT_NUM_SHARDS;
+  const int updates = (argc > 2) ? std::atoi(argv[2]) : DEFAULT_UPDATES;
+  const int random_seed = (argc > 3) ? std::atoi(argv[3]) : DEFAULT_RANDOM_SEED;
+  if (num_shards < 1) {
+    std::cerr << "Need at least one shard." << std::endl;
+    return 1;
+  }
+  return UnixSocketTransport::Launch(num_shards, [updates, random_seed](Transport &transport) {
+    return RunShard(transport, updates, random_seed);
+  });
+}
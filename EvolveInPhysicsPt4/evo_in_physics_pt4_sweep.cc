@@ -0,0 +1,143 @@
+/*
+  evo_in_physics_pt4_sweep.cc
+
+  Parameter sweep over the Pt4 experiment (see sweep/SweepSpec.h and
+  sweep/SuccessiveHalving.h).
+    * Which settings vary, and over what, comes from SWEEP_FILE; everything else from
+      evo-in-physics-pt4.cfg and/or the command line.
+    * SWEEP_MODE grid runs every combination, random runs SWEEP_SAMPLES random points
+      (drawn with RANDOM_SEED).
+    * Every point runs with SWEEP_REPLICATES seeds, starting at RANDOM_SEED (the point's own,
+      if the sweep file varies it). Points are cut by successive halving, from
+      SWEEP_MIN_UPDATES up to UPDATES.
+    * Results go to SWEEP_RESULTS_FILE, one row per point per rung; the points that made
+      it to the end are printed, best first.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "config/ArgManager.h"
+
+#include "evo_in_physics_pt4_config.h"
+#include "./sweep/SweepSpec.h"
+#include "./sweep/SuccessiveHalving.h"
+
+// One replicate of one sweep point.
+class Pt4Trial {
+  private:
+    emp::Random random;
+    SimplePhysicsWorld world;
+    int max_pop_size;
+    double mean_size;
+
+  public:
+    Pt4Trial(const Pt4Params &params, int seed)
+      : random(seed), world(random, "sweep-world"), max_pop_size(params.max_pop_size), mean_size(0.0)
+    {
+      ConfigWorld(world, params);
+      InsertAncestor(world, params, random);
+    }
+
+    void RunTo(int update) {
+      double total_size = 0.0;
+      int steps = 0;
+      while (world.update < update && world.popM.GetSize() > 0) {
+        world.Update();
+        total_size += world.popM.GetSize();
+        steps++;
+      }
+      mean_size = (steps > 0) ? total_size / steps : world.popM.GetSize();
+    }
+
+    int GetSize() const { return world.popM.GetSize(); }
+    double GetMeanSize() const { return mean_size; }
+    bool IsSaturated() const { return world.popM.GetSize() >= max_pop_size; }
+
+    emp::vector<double> GetStats() {
+      double total_energy = 0.0;
+      double total_ones = 0.0;
+      const int organisms = world.popM.GetSize();
+      for (int i = 0; i < organisms; i++) {
+        total_energy += world.popM[i]->GetEnergy();
+        total_ones += world.popM[i]->genome.CountOnes();
+      }
+      return { (double) world.popM.GetNumResources(),
+               (organisms > 0) ? total_energy / organisms : 0.0,
+               (organisms > 0) ? total_ones / organisms : 0.0 };
+    }
+};
+
+int main(int argc, char *argv[]) {
+  // Load config.
+  EvoInPhysicsPt4Config config;
+  std::string config_filename = "evo-in-physics-pt4.cfg";
+  config.Read(config_filename);
+  auto args = emp::cl::ArgManager(argc, argv);
+  if (!args.ProcessConfigOptions(config, std::cout, config_filename)) return 0;
+
+  // Work out which points to run.
+  SweepSpec spec;
+  if (!spec.Read(config.SWEEP_FILE())) return 1;
+  const Pt4Params base_params(config);
+  emp::vector<std::string> point_names;
+  for (int s = 0; s < spec.GetNumSettings(); s++) {
+    Pt4Params test_params(base_params);
+    if (!test_params.Set(spec.GetName(s), 0.0)) {
+      std::cerr << "Unknown setting in sweep file: " << spec.GetName(s) << std::endl;
+      return 1;
+    }
+    point_names.push_back(spec.GetName(s));
+  }
+  emp::vector<SweepSpec::point_t> points;
+  if (config.SWEEP_MODE() == "grid") points = spec.GetGridPoints();
+  else if (config.SWEEP_MODE() == "random") {
+    emp::Random sweep_random(config.RANDOM_SEED());
+    points = spec.GetRandomPoints(config.SWEEP_SAMPLES(), sweep_random);
+  } else {
+    std::cerr << "Unknown SWEEP_MODE: " << config.SWEEP_MODE() << " (expected grid or random)" << std::endl;
+    return 1;
+  }
+  emp::vector<Pt4Params> point_params(points.size(), base_params);
+  for (int p = 0; p < (int) points.size(); p++) {
+    for (int s = 0; s < (int) point_names.size(); s++) point_params[p].Set(point_names[s], points[p][s]);
+  }
+
+  int num_threads = config.SWEEP_THREADS();
+  if (num_threads <= 0) num_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  std::ofstream results_file(config.SWEEP_RESULTS_FILE());
+  if (!results_file) {
+    std::cerr << "Could not open " << config.SWEEP_RESULTS_FILE() << " for writing." << std::endl;
+    return 1;
+  }
+
+  // Run!
+  SuccessiveHalving<Pt4Trial> sweep(point_names, { "resources", "mean_energy", "mean_ones" }, results_file, num_threads);
+  sweep.SetSchedule(config.SWEEP_MIN_UPDATES(), config.UPDATES(), config.SWEEP_ETA(), config.PLATEAU_TOLERANCE());
+  const auto start_time = std::chrono::steady_clock::now();
+  const int first_seed = config.RANDOM_SEED();
+  sweep.Run(points, first_seed, config.SWEEP_REPLICATES(), [&point_params, first_seed](int point_id, int seed) {
+    // Replicate r of a point runs with the point's RANDOM_SEED + r.
+    return new Pt4Trial(point_params[point_id], point_params[point_id].random_seed + (seed - first_seed));
+  });
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+  // Report the points that made it all the way, best first.
+  emp::vector<int> finished;
+  for (int p = 0; p < (int) points.size(); p++) {
+    if (sweep.GetStatus(p) == SuccessiveHalving<Pt4Trial>::STATUS::FINISHED) finished.push_back(p);
+  }
+  std::stable_sort(finished.begin(), finished.end(), [&sweep](int a, int b) { return sweep.GetMeanSize(a) > sweep.GetMeanSize(b); });
+  for (int p : finished) {
+    std::cout << "Point " << p << ":";
+    for (int s = 0; s < (int) point_names.size(); s++) std::cout << " " << point_names[s] << "=" << points[p][s];
+    std::cout << " mean organisms " << sweep.GetMeanSize(p) << "\n";
+  }
+  std::cout << "Swept " << points.size() << " points on " << sweep.GetNumThreads() << " threads in "
+            << elapsed.count() << " seconds." << std::endl;
+  return 0;
+}
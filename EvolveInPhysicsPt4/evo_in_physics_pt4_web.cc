@@ -17,6 +17,7 @@
 #include "./organisms/SimpleOrganism.h"
 #include "./resources/SimpleResource.h"
 #include "./population-managers/PopulationManager_SimplePhysics.h"
+#include "./stats/PopulationStats.h"
 
 #include "web/web.h"
 #include "web/Document.h"
@@ -80,6 +81,7 @@ class EvoInPhysicsInterface {
 
     emp::Random *random;
     SimplePhysicsWorld *world;
+    PopulationStats pop_stats;    // Sampled once per frame, for the stats view.
     // Interface-specific objects.
     //  - Exp run views.
     web::Document dashboard;      // Visible during exp page mode.
@@ -190,6 +192,15 @@ class EvoInPhysicsInterface {
                       if (world != nullptr) return world->popM.GetNumResources();
                       else return -1; })
                  << "<br>";
+      stats_view << "Mean Energy: " << web::Live([this]() { return pop_stats.Get(POP_STAT::MEAN_ENERGY); }) << "<br>";
+      stats_view << "Max Energy: " << web::Live([this]() { return pop_stats.Get(POP_STAT::MAX_ENERGY); }) << "<br>";
+      stats_view << "Mean Ones: " << web::Live([this]() { return pop_stats.Get(POP_STAT::MEAN_ONES); }) << "<br>";
+      stats_view << "Genotypes: " << web::Live([this]() { return pop_stats.Get(POP_STAT::GENOTYPES); }) << "<br>";
+      stats_view << "Genotype Entropy: " << web::Live([this]() { return pop_stats.Get(POP_STAT::GENOTYPE_ENTROPY); }) << "<br>";
+      stats_view << "Dominant Genotype Count: " << web::Live([this]() { return pop_stats.Get(POP_STAT::DOMINANT_COUNT); }) << "<br>";
+      stats_view << "Mean Pressure: " << web::Live([this]() { return pop_stats.Get(POP_STAT::MEAN_PRESSURE); }) << "<br>";
+      stats_view << "Reproduction Links: " << web::Live([this]() { return pop_stats.Get(POP_STAT::REPRO_LINKS); }) << "<br>";
+      stats_view << "Consumption Links: " << web::Live([this]() { return pop_stats.Get(POP_STAT::CONSUME_LINKS); }) << "<br>";
       // --- Setup Config View. ---
       param_view.SetAttr("class", "well");
       // -- General --
@@ -349,6 +360,7 @@ class EvoInPhysicsInterface {
       // Draw
       web::Draw(world_view.Canvas("simple-world-canvas"), world->popM.GetPhysics().GetSurface(), emp::GetHueMap(360));
       //world->popM.GetPhysics().DrawOnCanvas(world_view.Canvas("simple-world-canvas"), emp::GetHueMap(360));
+      pop_stats.Sample(world->popM);
       stats_view.Redraw();
     }
 
@@ -380,6 +392,7 @@ class EvoInPhysicsInterface {
       ResetEvolution();
       web::Draw(world_view.Canvas("simple-world-canvas"), world->popM.GetPhysics().GetSurface(), emp::GetHueMap(360));
       //world->popM.GetPhysics().DrawOnCanvas(world_view.Canvas("simple-world-canvas"), emp::GetHueMap(360));
+      pop_stats.Sample(world->popM);
       stats_view.Redraw();
       return true;
     }
@@ -23,6 +23,7 @@ class SimpleOrganism {
     double energy;
     int resources_collected;
     bool detach_on_birth;
+    uint32_t entity_id;       // Assigned by the population manager; keys this organism's random streams.
 
   public:
     emp::BitVector genome;
@@ -36,6 +37,7 @@ class SimpleOrganism {
         energy(0.0),
         resources_collected(0.0),
         detach_on_birth(detach_on_birth),
+        entity_id(0),
         genome(genome_length, false)
     {
       AttachBody(new Body_t(_p));
@@ -55,6 +57,7 @@ class SimpleOrganism {
          energy(other.GetEnergy()),
          resources_collected(other.GetResourcesCollected()),
          detach_on_birth(other.GetDetachOnBirth()),
+         entity_id(0),
          genome(other.genome)
     {
       if (has_body) {
@@ -79,6 +82,7 @@ class SimpleOrganism {
     double GetBirthTime() const { return birth_time; }
     bool GetDetachOnBirth() const { return detach_on_birth; }
     double GetMembraneStrength() const { return membrane_strengh; }
+    uint32_t GetEntityID() const { return entity_id; }
     Body_t * GetBodyPtr() { emp_assert(has_body); return body; }
     Body_t & GetBody() { emp_assert(has_body); return *body; }
     const Body_t & GetConstBody() const { emp_assert(has_body) return *body; }
@@ -128,6 +132,9 @@ class SimpleOrganism {
       if (has_body) body->SetMaxPressure(membrane_strengh);
     }
     void SetEnergy(double e) { energy = e; }
+    void SetResourcesCollected(int count) { resources_collected = count; }
+    void SetOffspringCount(int count) { offspring_count = count; }
+    void SetEntityID(uint32_t id) { entity_id = id; }
     void SetBirthTime(double t) { birth_time = t; }
     void SetColorID(int id) { emp_assert(has_body); body->SetColorID(id); }
     void SetColorID() {
@@ -136,7 +143,9 @@ class SimpleOrganism {
       else body->SetColorID(0);
     }
 
-    SimpleOrganism * Reproduce(emp::Random *r, double mut_rate = 0.0, double cost = 0.0) {
+    // RANDOM can be emp::Random or CounterRandom.
+    template <typename RANDOM>
+    SimpleOrganism * Reproduce(RANDOM *r, double mut_rate = 0.0, double cost = 0.0) {
       energy -= cost;
       // Build offspring
       auto *offspring = new SimpleOrganism(*this);
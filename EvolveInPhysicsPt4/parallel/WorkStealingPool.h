@@ -0,0 +1,107 @@
+/*
+  parallel/WorkStealingPool.h
+    Defines WorkStealingPool, which runs a batch of independent, long and uneven tasks (whole
+    replicate runs, say) on a fixed number of threads.
+
+    Run(num_tasks, fun) calls fun(task) for every task in [0, num_tasks) and returns once they
+    are all done. Tasks are dealt out round-robin to one deque per thread (the calling thread
+    is thread 0). A thread works through its own deque from the front; once that is empty it
+    steals from the back of whichever deque has the most left, so threads that drew short
+    tasks take over the tail of those that drew long ones.
+
+    Unlike ThreadPool, which chunk a thread runs is not fixed, so tasks must not share
+    anything that is not thread-safe.
+*/
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <functional>
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+class WorkStealingPool {
+  public:
+    using task_fun_t = std::function<void(int)>;
+
+  private:
+    struct TaskDeque {
+      std::mutex mutex;
+      std::deque<int> tasks;
+    };
+
+    const int num_threads;
+    emp::vector<TaskDeque> deques;
+    int steal_count;          // Tasks run by a thread other than the one they were dealt to.
+    std::mutex steal_mutex;
+
+    bool PopOwn(int thread_id, int &task) {
+      TaskDeque &own = deques[thread_id];
+      std::lock_guard<std::mutex> guard(own.mutex);
+      if (own.tasks.empty()) return false;
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+
+    bool Steal(int thread_id, int &task) {
+      while (true) {
+        // Pick the fullest victim (sizes are only a hint; check again under its lock).
+        int victim = -1;
+        size_t victim_size = 0;
+        for (int t = 0; t < num_threads; t++) {
+          if (t == thread_id) continue;
+          std::lock_guard<std::mutex> guard(deques[t].mutex);
+          if (deques[t].tasks.size() > victim_size) {
+            victim = t;
+            victim_size = deques[t].tasks.size();
+          }
+        }
+        if (victim < 0) return false;
+        std::lock_guard<std::mutex> guard(deques[victim].mutex);
+        if (deques[victim].tasks.empty()) continue;
+        task = deques[victim].tasks.back();
+        deques[victim].tasks.pop_back();
+        return true;
+      }
+    }
+
+    void RunThread(int thread_id, const task_fun_t &fun) {
+      int task;
+      while (PopOwn(thread_id, task)) fun(task);
+      // Nothing new is ever dealt during a Run, so once stealing fails we are done.
+      while (Steal(thread_id, task)) {
+        {
+          std::lock_guard<std::mutex> guard(steal_mutex);
+          steal_count++;
+        }
+        fun(task);
+      }
+    }
+
+  public:
+    WorkStealingPool(int _num_threads) : num_threads(_num_threads), deques(_num_threads), steal_count(0) {
+      emp_assert(num_threads > 0);
+    }
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+    int GetNumThreads() const { return num_threads; }
+    int GetStealCount() const { return steal_count; }
+
+    void Run(int num_tasks, const task_fun_t &fun) {
+      for (int task = 0; task < num_tasks; task++) deques[task % num_threads].tasks.push_back(task);
+      emp::vector<std::thread> workers;
+      for (int t = 1; t < num_threads && t < num_tasks; t++) {
+        workers.emplace_back(&WorkStealingPool::RunThread, this, t, std::cref(fun));
+      }
+      RunThread(0, fun);
+      for (auto &worker : workers) worker.join();
+    }
+};
+
+#endif
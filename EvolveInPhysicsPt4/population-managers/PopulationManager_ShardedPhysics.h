@@ -0,0 +1,375 @@
+/*
+  PopulationManager_ShardedPhysics.h
+    One shard of a PopulationManager_SimplePhysics world that is split across processes.
+
+    The world is cut into vertical stripes, one per shard (transport rank). Each shard runs
+    the ordinary SimplePhysics update on the entities in its stripe; every update it also:
+      1. Exchanges ghosts: entities within halo_width of a shared edge are copied to the
+         neighboring shard, which adds them to its physics for that update only. Ghosts
+         push local bodies around but are never fed, eaten, or updated otherwise, and are
+         thrown away after the physics step.
+      2. Settles meals across the seam: a resource is only ever eaten on the shard that owns
+         it, but ghost organisms may eat it there. The ghost's energy is sent back to its
+         home shard (by entity ID) right after the update and credited to the organism.
+         Unlike in an unsharded world, that energy arrives after the update's reproduction
+         step (so it counts from the next update on), and it is lost if the organism was
+         popped or culled in the same update.
+      3. Agrees on the population cap: every shard reports how many organisms it would have
+         (survivors plus offspring) to rank 0, which hands out local caps summing to the
+         global max_pop_size, in proportion to those counts (slots left over after rounding
+         down go to the shards with the largest remainders, lower ranks first on ties).
+      4. Migrates: entities whose centers left the stripe are sent (genome plus body state)
+         to the neighbor on that side and re-added there with a new entity ID. Their links
+         do not travel with them.
+    Each exchange waits on the neighbors (and the cap on every shard), so shards run in
+    lockstep. Resource inflow and the resource cap are split between shards by stripe width.
+
+    Setup: construct the World as usual, then call popM.SetTransport(&transport) before
+    ConfigPop.
+*/
+
+#ifndef POPULATION_MANAGER_SHARDED_PHYSICS_H
+#define POPULATION_MANAGER_SHARDED_PHYSICS_H
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "PopulationManager_SimplePhysics.h"
+#include "../sharding/Transport.h"
+#include "../../shared/serialize/Bytes.h"
+#include "../sharding/EntityCodec.h"
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+namespace emp {
+namespace evo {
+
+template <typename ORG>
+class PopulationManager_ShardedPhysics : public PopulationManager_SimplePhysics<ORG> {
+  protected:
+    using base_t = PopulationManager_SimplePhysics<ORG>;
+    using Org_t = ORG;
+    using Resource_t = SimpleResource;
+
+    Transport *transport;
+    int rank;
+    int num_shards;
+    double stripe_min_x;
+    double stripe_max_x;
+    double halo_width;            // 0 means "twice the largest organism/resource radius".
+
+    int global_max_pop_size;
+    int global_size;              // Organisms across all shards (as of the last cap agreement).
+    int migrated_in;
+    int migrated_out;
+
+    emp::vector<Org_t*> ghost_orgs;
+    emp::vector<Resource_t*> ghost_resources;
+
+    // Where each ghost organism lives (its entity ID on its own shard, and which side that is).
+    struct GhostHome {
+      uint32_t entity_id;
+      bool from_left;
+    };
+    std::unordered_map<const SimpleOrganism *, GhostHome> ghost_homes;
+
+    // Energy ghosts ate here this update, to send home.
+    struct MealCredit {
+      uint32_t entity_id;
+      double value;
+    };
+    emp::vector<MealCredit> left_credits;
+    emp::vector<MealCredit> right_credits;
+
+    // Part of total that belongs to shard r (shares add up to total).
+    int Share(int total, int r) const {
+      return (int) (((long long) total * (r + 1)) / num_shards - ((long long) total * r) / num_shards);
+    }
+
+    double GetHaloWidth() const {
+      if (halo_width > 0.0) return halo_width;
+      return 2.0 * std::max(this->max_organism_radius, this->resource_radius);
+    }
+
+    template <typename T>
+    static double GetX(T *entity) { return entity->GetBody().GetShape().GetCenter().GetX(); }
+
+    // Send a message to each neighbor and wait for theirs (empty if there is no such neighbor).
+    void ExchangeWithNeighbors(const std::string &to_left, const std::string &to_right,
+                               std::string &from_left, std::string &from_right) {
+      if (rank > 0) transport->Send(rank - 1, to_left);
+      if (rank + 1 < num_shards) transport->Send(rank + 1, to_right);
+      from_left.clear();
+      from_right.clear();
+      if (rank > 0) from_left = transport->Receive(rank - 1);
+      if (rank + 1 < num_shards) from_right = transport->Receive(rank + 1);
+    }
+
+    template <typename T>
+    static void EncodeAll(ByteWriter &writer, const emp::vector<T*> &entities) {
+      writer.Write((int) entities.size());
+      for (T *entity : entities) Encode(writer, *entity);
+    }
+
+    template <typename T>
+    static void DecodeAll(ByteReader &reader, emp::vector<T*> &entities) {
+      const int count = reader.Read<int>();
+      for (int i = 0; i < count; i++) {
+        T *entity;
+        Decode(reader, entity);
+        entities.push_back(entity);
+      }
+    }
+
+    void ExchangeGhosts() {
+      const double halo = GetHaloWidth();
+      emp::vector<Org_t*> left_orgs, right_orgs;
+      emp::vector<Resource_t*> left_resources, right_resources;
+      for (auto *org : this->population) {
+        if (!org->HasBody()) continue;
+        if (GetX(org) < stripe_min_x + halo) left_orgs.push_back(org);
+        if (GetX(org) >= stripe_max_x - halo) right_orgs.push_back(org);
+      }
+      for (auto *res : this->resources) {
+        if (!res->HasBody()) continue;
+        if (GetX(res) < stripe_min_x + halo) left_resources.push_back(res);
+        if (GetX(res) >= stripe_max_x - halo) right_resources.push_back(res);
+      }
+      ByteWriter to_left, to_right;
+      EncodeAll(to_left, left_orgs);
+      for (auto *org : left_orgs) to_left.Write(org->GetEntityID());
+      EncodeAll(to_left, left_resources);
+      EncodeAll(to_right, right_orgs);
+      for (auto *org : right_orgs) to_right.Write(org->GetEntityID());
+      EncodeAll(to_right, right_resources);
+      std::string from_left, from_right;
+      ExchangeWithNeighbors(to_left.GetBuffer(), to_right.GetBuffer(), from_left, from_right);
+      for (const std::string *message : { &from_left, &from_right }) {
+        if (message->empty()) continue;
+        ByteReader reader(*message);
+        const int first_org = (int) ghost_orgs.size();
+        DecodeAll(reader, ghost_orgs);
+        for (int i = first_org; i < (int) ghost_orgs.size(); i++) {
+          ghost_homes[ghost_orgs[i]] = GhostHome{ reader.Read<uint32_t>(), message == &from_left };
+        }
+        DecodeAll(reader, ghost_resources);
+        emp_assert(reader.AtEnd());
+      }
+      // Ghosts get no entity ID here: ghost resources are never eaten, and ghost organisms are
+      // only known (for eating) through ghost_homes.
+      for (auto *org : ghost_orgs) this->physics.AddBody(org);
+      for (auto *res : ghost_resources) this->physics.AddBody(res);
+    }
+
+    void ClearGhosts() {
+      for (auto *org : ghost_orgs) delete org;
+      for (auto *res : ghost_resources) delete res;
+      ghost_orgs.resize(0);
+      ghost_resources.resize(0);
+      ghost_homes.clear();
+    }
+
+    uint32_t GetConsumerID(const SimpleOrganism *org) const {
+      if (org->GetEntityID() != 0) return org->GetEntityID();
+      auto it = ghost_homes.find(org);
+      return (it == ghost_homes.end()) ? 0 : it->second.entity_id;
+    }
+
+    void FeedConsumer(Org_t *consumer, const Resource_t &resource) {
+      auto it = ghost_homes.find(consumer);
+      if (it == ghost_homes.end()) {
+        base_t::FeedConsumer(consumer, resource);
+        return;
+      }
+      (it->second.from_left ? left_credits : right_credits).push_back(MealCredit{ it->second.entity_id, resource.GetValue() });
+    }
+
+    // Send what ghosts ate here to their shards, and feed our organisms that ate as ghosts.
+    void SettleMeals() {
+      ByteWriter to_left, to_right;
+      for (auto *credits : { &left_credits, &right_credits }) {
+        ByteWriter &writer = (credits == &left_credits) ? to_left : to_right;
+        writer.Write((int) credits->size());
+        for (const MealCredit &credit : *credits) writer.Write(credit.entity_id).Write(credit.value);
+        credits->resize(0);
+      }
+      std::string from_left, from_right;
+      ExchangeWithNeighbors(to_left.GetBuffer(), to_right.GetBuffer(), from_left, from_right);
+      std::unordered_map<uint32_t, Org_t *> orgs_by_id;
+      for (const std::string *message : { &from_left, &from_right }) {
+        if (message->empty()) continue;
+        ByteReader reader(*message);
+        const int count = reader.Read<int>();
+        if (count > 0 && orgs_by_id.empty()) {
+          for (auto *org : this->population) orgs_by_id[org->GetEntityID()] = org;
+        }
+        for (int i = 0; i < count; i++) {
+          const uint32_t entity_id = reader.Read<uint32_t>();
+          const double value = reader.Read<double>();
+          auto it = orgs_by_id.find(entity_id);
+          if (it == orgs_by_id.end()) continue;     // Popped or culled this update.
+          it->second->SetEnergy(it->second->GetEnergy() + value);
+          it->second->SetResourcesCollected(it->second->GetResourcesCollected() + 1);
+        }
+        emp_assert(reader.AtEnd());
+      }
+    }
+
+    // Pull entities that left the stripe out of 'entities', sorted by which side they left.
+    template <typename T>
+    void CollectMigrants(emp::vector<T*> &entities, emp::vector<T*> &to_left, emp::vector<T*> &to_right) {
+      int kept = 0;
+      for (T *entity : entities) {
+        const double x = GetX(entity);
+        if (x < stripe_min_x && rank > 0) to_left.push_back(entity);
+        else if (x >= stripe_max_x && rank + 1 < num_shards) to_right.push_back(entity);
+        else entities[kept++] = entity;
+      }
+      entities.resize(kept);
+    }
+
+    void Migrate() {
+      emp::vector<Org_t*> left_orgs, right_orgs;
+      emp::vector<Resource_t*> left_resources, right_resources;
+      CollectMigrants(this->population, left_orgs, right_orgs);
+      CollectMigrants(this->resources, left_resources, right_resources);
+      ByteWriter to_left, to_right;
+      EncodeAll(to_left, left_orgs);
+      EncodeAll(to_left, left_resources);
+      EncodeAll(to_right, right_orgs);
+      EncodeAll(to_right, right_resources);
+      migrated_out += (int) (left_orgs.size() + right_orgs.size());
+      for (auto *org : left_orgs) this->DeleteOrg(org);
+      for (auto *org : right_orgs) this->DeleteOrg(org);
+      for (auto *res : left_resources) delete res;
+      for (auto *res : right_resources) delete res;
+      std::string from_left, from_right;
+      ExchangeWithNeighbors(to_left.GetBuffer(), to_right.GetBuffer(), from_left, from_right);
+      for (const std::string *message : { &from_left, &from_right }) {
+        if (message->empty()) continue;
+        ByteReader reader(*message);
+        emp::vector<Org_t*> orgs;
+        emp::vector<Resource_t*> resources;
+        DecodeAll(reader, orgs);
+        DecodeAll(reader, resources);
+        emp_assert(reader.AtEnd());
+        migrated_in += (int) orgs.size();
+        for (auto *org : orgs) this->AddOrg(org);
+        for (auto *res : resources) this->AddResource(res);
+      }
+    }
+
+  public:
+    PopulationManager_ShardedPhysics()
+      : base_t(), transport(nullptr), rank(0), num_shards(1), stripe_min_x(0.0), stripe_max_x(0.0),
+        halo_width(0.0), global_max_pop_size(1), global_size(0), migrated_in(0), migrated_out(0)
+    { ; }
+
+    ~PopulationManager_ShardedPhysics() { ClearGhosts(); }
+
+    // Which transport connects this shard to the others? (Call after Setup, before ConfigPop.)
+    void SetTransport(Transport *_transport) {
+      transport = _transport;
+      rank = transport->GetRank();
+      num_shards = transport->GetNumRanks();
+      // Shards draw from different streams, and never hand out the same entity ID.
+      this->rng_seed += 0x9E3779B9u * (uint32_t) rank;
+      this->SetEntityIDs((uint32_t) rank + 1, (uint32_t) num_shards);
+    }
+
+    void SetHaloWidth(double width) { halo_width = width; }
+
+    int GetRank() const { return rank; }
+    int GetNumShards() const { return num_shards; }
+    double GetStripeMinX() const { return stripe_min_x; }
+    double GetStripeMaxX() const { return stripe_max_x; }
+    int GetGlobalSize() const { return global_size; }
+    int GetMigratedIn() const { return migrated_in; }
+    int GetMigratedOut() const { return migrated_out; }
+
+    // Same parameters as PopulationManager_SimplePhysics::ConfigPop, for the whole world.
+    void ConfigPop(double width, double height, double surface_friction,
+                   int max_pop_size, double point_mutation_rate, double max_organism_radius,
+                   double cost_of_repro, int max_resource_age, int max_resource_count,
+                   int resource_in_flow_rate, double resource_radius, double resource_value,
+                   double movement_noise) {
+      emp_assert(transport != nullptr);
+      base_t::ConfigPop(width, height, surface_friction, max_pop_size, point_mutation_rate,
+                        max_organism_radius, cost_of_repro, max_resource_age,
+                        Share(max_resource_count, rank), Share(resource_in_flow_rate, rank),
+                        resource_radius, resource_value, movement_noise);
+      global_max_pop_size = max_pop_size;
+      stripe_min_x = width * rank / num_shards;
+      stripe_max_x = width * (rank + 1) / num_shards;
+      this->SetResourceRegion(stripe_min_x, stripe_max_x);
+    }
+
+    // Does x lie in this shard's stripe? (Use to decide which shard inserts an organism.)
+    bool InStripe(double x) const {
+      return (x >= stripe_min_x || rank == 0) && (x < stripe_max_x || rank + 1 == num_shards);
+    }
+
+    // Local cap, agreed with every other shard through rank 0.
+    int GetPopCap(int num_candidates) {
+      if (num_shards == 1) {
+        global_size = std::min(num_candidates, global_max_pop_size);
+        return global_max_pop_size;
+      }
+      if (rank != 0) {
+        ByteWriter request;
+        request.Write(num_candidates);
+        transport->Send(0, request.GetBuffer());
+        const std::string reply = transport->Receive(0);
+        ByteReader reader(reply);
+        const int cap = reader.Read<int>();
+        global_size = reader.Read<int>();
+        return cap;
+      }
+      emp::vector<int> candidates(num_shards, num_candidates);
+      for (int r = 1; r < num_shards; r++) {
+        const std::string request = transport->Receive(r);
+        ByteReader reader(request);
+        candidates[r] = reader.Read<int>();
+      }
+      long long total = 0;
+      for (int count : candidates) total += count;
+      emp::vector<int> caps(candidates);
+      if (total > global_max_pop_size) {
+        int assigned = 0;
+        emp::vector<long long> remainders(num_shards);
+        for (int r = 0; r < num_shards; r++) {
+          caps[r] = (int) ((candidates[r] * (long long) global_max_pop_size) / total);
+          remainders[r] = (candidates[r] * (long long) global_max_pop_size) % total;
+          assigned += caps[r];
+        }
+        // Hand out what is left to the largest remainders (lower ranks first on ties).
+        emp::vector<int> order(num_shards);
+        for (int r = 0; r < num_shards; r++) order[r] = r;
+        std::stable_sort(order.begin(), order.end(), [&remainders](int a, int b) { return remainders[a] > remainders[b]; });
+        for (int i = 0; assigned < global_max_pop_size; i++, assigned++) caps[order[i]]++;
+      }
+      global_size = (int) std::min<long long>(total, global_max_pop_size);
+      for (int r = 1; r < num_shards; r++) {
+        ByteWriter reply;
+        reply.Write(caps[r]).Write(global_size);
+        transport->Send(r, reply.GetBuffer());
+      }
+      return caps[0];
+    }
+
+    // Progress time by one step (in lockstep with the other shards).
+    void Update() {
+      emp_assert(transport != nullptr);
+      ExchangeGhosts();
+      base_t::Update();
+      SettleMeals();
+      ClearGhosts();
+      Migrate();
+    }
+};
+
+}
+}
+
+#endif
@@ -7,9 +7,18 @@
 
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
 
 #include "physics/Physics2D.h"
 #include "../resources/SimpleResource.h"
+#include "../random/CounterRandom.h"
+#include "../random/BulkNoise.h"
+#include "../../shared/parallel/ThreadPool.h"
+#include "../../shared/checkpoint/CheckpointFile.h"
+#include "../events/EventLog.h"
+#include "../../shared/stats/GenotypeCensus.h"
 
 #include "evo/PopulationManager.h"
 #include "tools/vector.h"
@@ -40,6 +49,35 @@ class PopulationManager_SimplePhysics {
     emp::vector<Resource_t*> resources;
 
     Random *random_ptr;   // This comes from world. PopManager does not own random_ptr.
+    // All random draws during Update come from CounterRandom streams keyed by
+    // (rng_seed, update_count, purpose, entity id), so they do not depend on processing order.
+    uint32_t rng_seed;
+    uint32_t update_count;
+    uint32_t next_entity_id;
+    uint32_t entity_id_stride;   // IDs go next_entity_id, next_entity_id + stride, ...
+    BulkNoise noise;      // Movement noise for every body, generated in one batch per update.
+
+    // Update runs its per-entity work in parallel passes over fixed-size chunks.
+    //  * Mark: decide each resource's/organism's fate; organisms reproduce into a per-chunk
+    //    birth buffer. Only touches the entity itself (and its brand new offspring).
+    //  * Apply: feed consumed resources to their consumers and delete the dead (serially,
+    //    since deleting a body unlinks it from other bodies).
+    //  * Compact: survivors are packed down in order, in parallel.
+    // Births are merged in chunk order, so results do not depend on the number of threads.
+    enum class FATE : char { ALIVE, DEAD, CONSUMED, AGED };
+    static constexpr int CHUNK_SIZE = 256;
+    std::unique_ptr<ThreadPool> thread_pool;
+    emp::vector<FATE> resource_fates;
+    emp::vector<Org_t*> resource_consumers;
+    emp::vector<FATE> org_fates;
+    emp::vector<emp::vector<Org_t*> > chunk_births;
+    emp::vector<int> chunk_offsets;
+    emp::vector<Resource_t*> resource_scratch;
+    emp::vector<Org_t*> org_scratch;
+    emp::vector<emp::vector<Org_t*> > chunk_parents;    // Who each birth came from (only kept when logging).
+
+    EventLog *event_log;  // Where to log births, deaths, etc. (null for nowhere). Not owned.
+    GenotypeCensus<> census;  // Kept up to date by AddOrg and DeleteOrg.
 
     // Population manager parameters.
     int max_pop_size;
@@ -54,14 +92,74 @@ class PopulationManager_SimplePhysics {
     double resource_value;
 
     double movement_noise;
+    double surface_friction;
+
+    // New resources are placed with their centers in [resource_min_x, resource_max_x).
+    double resource_min_x;
+    double resource_max_x;
 
     // Useful things to not have to look up all of the time.
     static constexpr int RESOURCE_PHYSICS_BODY_TYPE_ID = Physics_t::template GetTypeID<SimpleResource>();
     static constexpr int ORG_PHYSICS_BODY_TYPE_ID = Physics_t::template GetTypeID<SimpleOrganism>();
 
+    // Shape, velocity, mass and color (what a body keeps from one update to the next).
+    static void SaveBody(ByteWriter &writer, const Body<Circle> &body) {
+      const Circle &circle = body.GetConstShape();
+      writer.Write(circle.GetCenter().GetX()).Write(circle.GetCenter().GetY()).Write(circle.GetRadius());
+      writer.Write(body.GetVelocity().GetX()).Write(body.GetVelocity().GetY()).Write(body.GetMass());
+      writer.Write((int) body.GetColorID());
+    }
+
+    // Every organism leaves the population through here.
+    void DeleteOrg(Org_t *org) {
+      census.Remove(org->genome);
+      delete org;
+    }
+
+    // Which entity is eating when org eats one of our resources? (0 if org may not eat here.)
+    // Derived managers can let organisms that are not in this population (e.g. ghosts from
+    // another shard) eat.
+    virtual uint32_t GetConsumerID(const SimpleOrganism *org) const { return org->GetEntityID(); }
+
+    // Hand a consumed resource's value to whoever ate it.
+    virtual void FeedConsumer(Org_t *consumer, const Resource_t &resource) { consumer->ConsumeResource(resource); }
+
+    struct BodyState {
+      Circle circle;
+      Point<double> velocity;
+      double mass;
+      int color_id;
+
+      BodyState(ByteReader &reader) : circle(Point<double>(0.0, 0.0), 0.0) {
+        const double x = reader.Read<double>();
+        const double y = reader.Read<double>();
+        const double radius = reader.Read<double>();
+        circle = Circle(Point<double>(x, y), radius);
+        const double vx = reader.Read<double>();
+        const double vy = reader.Read<double>();
+        velocity = Point<double>(vx, vy);
+        mass = reader.Read<double>();
+        color_id = reader.Read<int>();
+      }
+
+      template <typename BODY>
+      void Apply(BODY &body) const {
+        body.SetVelocity(velocity);
+        body.SetMass(mass);
+        body.SetColorID(color_id);
+      }
+    };
+
   public:
     PopulationManager_SimplePhysics()
       : physics(),
+        random_ptr(nullptr),
+        rng_seed(0),
+        update_count(0),
+        next_entity_id(1),
+        entity_id_stride(1),
+        thread_pool(new ThreadPool(1)),
+        event_log(nullptr),
         max_pop_size(1),
         point_mutation_rate(0.0075),
         max_organism_radius(1.0),
@@ -71,7 +169,10 @@ class PopulationManager_SimplePhysics {
         resource_in_flow_rate(1),
         resource_radius(1.0),
         resource_value(1.0),
-        movement_noise(0.1)
+        movement_noise(0.1),
+        surface_friction(0.0),
+        resource_min_x(0.0),
+        resource_max_x(std::numeric_limits<double>::max())
     {
       std::function<void(SimpleOrganism*, SimpleResource*)> f =
         [this](SimpleOrganism *org, SimpleResource *res) {
@@ -80,7 +181,7 @@ class PopulationManager_SimplePhysics {
       physics.RegisterCollisionHandler(f);
     }
 
-    ~PopulationManager_SimplePhysics() { ; }
+    virtual ~PopulationManager_SimplePhysics() { ; }
 
     // Allow this and derived classes to be identified as a population manager:
     static constexpr bool emp_is_population_manager = true;
@@ -100,28 +201,61 @@ class PopulationManager_SimplePhysics {
     int GetSize() const { return (int) this->size(); }
     int GetNumResources() const { return (int) resources.size(); }
     Physics_t & GetPhysics() { return physics; }
+    const GenotypeCensus<> & GetCensus() const { return census; }
 
     // Add new organism. Return position in population.
     int AddOrg(Org_t *new_org) {
       int pos = this->GetSize();
+      new_org->SetEntityID(next_entity_id);
+      next_entity_id += entity_id_stride;
       population.push_back(new_org);
+      census.Add(new_org->genome);
       physics.AddBody(new_org);
       return pos;
     }
 
     int AddResource(Resource_t *new_res) {
       int pos = this->GetNumResources();
+      new_res->SetEntityID(next_entity_id);
+      next_entity_id += entity_id_stride;
       resources.push_back(new_res);
       physics.AddBody(new_res);
       return pos;
     }
 
-    void Setup(Random *r) { random_ptr = r; }
+    // How many threads should Update use?
+    void SetNumThreads(int num_threads) { thread_pool.reset(new ThreadPool(num_threads)); }
+    int GetNumThreads() const { return thread_pool->GetNumThreads(); }
+    // Only use between updates.
+    ThreadPool & GetThreadPool() { return *thread_pool; }
+
+    // Hand out entity IDs first_id, first_id + stride, ... (so several managers can share an
+    // ID space without overlapping).
+    void SetEntityIDs(uint32_t first_id, uint32_t stride) {
+      emp_assert(first_id > 0 && stride > 0);
+      next_entity_id = first_id;
+      entity_id_stride = stride;
+    }
+
+    // Only place new resources with their centers in [min_x, max_x).
+    void SetResourceRegion(double min_x, double max_x) {
+      resource_min_x = min_x;
+      resource_max_x = max_x;
+    }
+
+    // How many organisms may be kept this update, given how many there would be without culling?
+    virtual int GetPopCap(int num_candidates) { return max_pop_size; }
+
+    void Setup(Random *r) {
+      random_ptr = r;
+      rng_seed = r->GetUInt();
+    }
 
     void Clear() {
       physics.Clear();
       population.clear();
       resources.clear();
+      census.Clear();
     }
 
     void ConfigPop(double width, double height, double surface_friction,
@@ -140,18 +274,185 @@ class PopulationManager_SimplePhysics {
       this->resource_radius = resource_radius;
       this->resource_value = resource_value;
       this->movement_noise = movement_noise;
+      this->surface_friction = surface_friction;
       // Config the physics.
       physics.ConfigPhysics(width, height, random_ptr, surface_friction);
     }
 
+    // Change the settings that only take effect as the population turns over (e.g., to send a
+    // running world down a different path). World size and friction are fixed by ConfigPop.
+    void ReconfigPop(int max_pop_size, double point_mutation_rate, double cost_of_repro,
+                     int max_resource_age, int max_resource_count, int resource_in_flow_rate,
+                     double resource_radius, double resource_value, double movement_noise) {
+      this->max_pop_size = max_pop_size;
+      this->point_mutation_rate = point_mutation_rate;
+      this->cost_of_repro = cost_of_repro;
+      this->max_resource_age = max_resource_age;
+      this->max_resource_count = max_resource_count;
+      this->resource_in_flow_rate = resource_in_flow_rate;
+      this->resource_radius = resource_radius;
+      this->resource_value = resource_value;
+      this->movement_noise = movement_noise;
+    }
+
+    // Log every update's events to log from now on (null to stop), starting with a keyframe of
+    // the population as it is.
+    void SetEventLog(EventLog *log) {
+      event_log = log;
+      if (event_log) event_log->WriteKeyframe(update_count, population, resources);
+    }
+
+    // Key all random draws from here on by a new seed.
+    void SetRandomSeed(uint32_t seed) { rng_seed = seed; }
+
+    // Write everything needed to carry on from this point: parameters, random stream keys,
+    // every organism and resource (including entity IDs) and every link between their bodies.
+    // Call between updates.
+    void SaveState(ByteWriter &writer) {
+      writer.Write(physics.GetWidth()).Write(physics.GetHeight()).Write(surface_friction);
+      writer.Write(max_pop_size).Write(point_mutation_rate).Write(max_organism_radius).Write(cost_of_repro);
+      writer.Write(max_resource_age).Write(max_resource_count).Write(resource_in_flow_rate);
+      writer.Write(resource_radius).Write(resource_value).Write(movement_noise);
+      writer.Write(resource_min_x).Write(resource_max_x);
+      writer.Write(rng_seed).Write(update_count).Write(next_entity_id).Write(entity_id_stride);
+      // Bodies are numbered organisms first, then resources (links refer to them by number).
+      std::unordered_map<const Body2D_Base *, int> body_ids;
+      emp::vector<Body<Circle> *> bodies;
+      writer.Write((int) population.size());
+      for (auto *org : population) {
+        SaveBody(writer, org->GetBody());
+        writer.Write(org->GetEntityID());
+        writer.Write(org->genome);
+        writer.Write(org->GetEnergy()).Write(org->GetResourcesCollected()).Write(org->GetOffspringCount());
+        writer.Write(org->GetBirthTime()).Write(org->GetMembraneStrength()).Write(org->GetDetachOnBirth());
+        body_ids[org->GetBodyPtr()] = (int) bodies.size();
+        bodies.push_back(org->GetBodyPtr());
+      }
+      writer.Write((int) resources.size());
+      for (auto *res : resources) {
+        SaveBody(writer, res->GetBody());
+        writer.Write(res->GetEntityID());
+        writer.Write(res->GetValue()).Write(res->GetAge());
+        body_ids[res->GetBodyPtr()] = (int) bodies.size();
+        bodies.push_back(res->GetBodyPtr());
+      }
+      // Links are found by walking each body's incoming links of every kind.
+      const BODY_LINK_TYPE link_types[] = { BODY_LINK_TYPE::DEFAULT, BODY_LINK_TYPE::REPRODUCTION,
+                                            BODY_LINK_TYPE::ATTACK, BODY_LINK_TYPE::PARASITE,
+                                            BODY_LINK_TYPE::CONSUME_RESOURCE };
+      emp::vector<BodyLink *> links;
+      emp::vector<int> link_ends;
+      for (int to_id = 0; to_id < (int) bodies.size(); to_id++) {
+        for (BODY_LINK_TYPE type : link_types) {
+          for (auto *link : bodies[to_id]->GetLinksToByType(type)) {
+            auto from = body_ids.find(link->from);
+            if (from == body_ids.end()) continue;   // Not one of ours (e.g. a ghost).
+            links.push_back(link);
+            link_ends.push_back(from->second);
+            link_ends.push_back(to_id);
+          }
+        }
+      }
+      writer.Write((int) links.size());
+      for (int i = 0; i < (int) links.size(); i++) {
+        writer.Write(link_ends[2 * i]).Write(link_ends[2 * i + 1]).Write((int) links[i]->type);
+        writer.Write(links[i]->cur_dist).Write(links[i]->target_dist).Write(links[i]->link_strength);
+        writer.Write(links[i]->flag_for_removal);
+      }
+    }
+
+    // Rebuild the state written by SaveState. Only call on a manager that has been Setup but
+    // not yet configured or populated.
+    bool LoadState(ByteReader &reader) {
+      emp_assert(population.size() == 0 && resources.size() == 0);
+      const double width = reader.Read<double>();
+      const double height = reader.Read<double>();
+      const double friction = reader.Read<double>();
+      const int pop_size = reader.Read<int>();
+      const double mutation_rate = reader.Read<double>();
+      const double organism_radius = reader.Read<double>();
+      const double repro_cost = reader.Read<double>();
+      const int resource_age = reader.Read<int>();
+      const int resource_count = reader.Read<int>();
+      const int in_flow_rate = reader.Read<int>();
+      const double res_radius = reader.Read<double>();
+      const double res_value = reader.Read<double>();
+      const double noise_magnitude = reader.Read<double>();
+      if (!reader.IsOK()) return false;
+      ConfigPop(width, height, friction, pop_size, mutation_rate, organism_radius, repro_cost,
+                resource_age, resource_count, in_flow_rate, res_radius, res_value, noise_magnitude);
+      resource_min_x = reader.Read<double>();
+      resource_max_x = reader.Read<double>();
+      rng_seed = reader.Read<uint32_t>();
+      update_count = reader.Read<uint32_t>();
+      const uint32_t saved_next_entity_id = reader.Read<uint32_t>();
+      const uint32_t saved_entity_id_stride = reader.Read<uint32_t>();
+      emp::vector<Body<Circle> *> bodies;
+      const int num_orgs = reader.Read<int>();
+      for (int i = 0; i < num_orgs && reader.IsOK(); i++) {
+        const BodyState body_state(reader);
+        const uint32_t entity_id = reader.Read<uint32_t>();
+        emp::BitVector genome(0);
+        reader.Read(genome);
+        auto *org = new Org_t(body_state.circle, genome.GetSize());
+        org->genome = genome;
+        org->SetEnergy(reader.Read<double>());
+        org->SetResourcesCollected(reader.Read<int>());
+        org->SetOffspringCount(reader.Read<int>());
+        org->SetBirthTime(reader.Read<double>());
+        org->SetMembraneStrength(reader.Read<double>());
+        org->SetDetachOnBirth(reader.Read<bool>());
+        body_state.Apply(org->GetBody());
+        AddOrg(org);
+        org->SetEntityID(entity_id);
+        bodies.push_back(org->GetBodyPtr());
+      }
+      const int num_resources = reader.Read<int>();
+      for (int i = 0; i < num_resources && reader.IsOK(); i++) {
+        const BodyState body_state(reader);
+        const uint32_t entity_id = reader.Read<uint32_t>();
+        auto *res = new Resource_t(body_state.circle);
+        res->SetValue(reader.Read<double>());
+        res->SetAge(reader.Read<double>());
+        body_state.Apply(res->GetBody());
+        AddResource(res);
+        res->SetEntityID(entity_id);
+        bodies.push_back(res->GetBodyPtr());
+      }
+      next_entity_id = saved_next_entity_id;
+      entity_id_stride = saved_entity_id_stride;
+      const int num_links = reader.Read<int>();
+      for (int i = 0; i < num_links && reader.IsOK(); i++) {
+        const int from_id = reader.Read<int>();
+        const int to_id = reader.Read<int>();
+        const BODY_LINK_TYPE type = (BODY_LINK_TYPE) reader.Read<int>();
+        const double cur_dist = reader.Read<double>();
+        const double target_dist = reader.Read<double>();
+        const double link_strength = reader.Read<double>();
+        const bool flag_for_removal = reader.Read<bool>();
+        if (!reader.IsOK() || from_id < 0 || to_id < 0 || from_id >= (int) bodies.size() || to_id >= (int) bodies.size()) return false;
+        bodies[from_id]->AddLink(type, *bodies[to_id], cur_dist, target_dist, link_strength);
+        for (auto *link : bodies[to_id]->GetLinksToByType(type)) {
+          if (link->from == bodies[from_id]) link->flag_for_removal = flag_for_removal;
+        }
+      }
+      return reader.IsOK();
+    }
+
     void ResOrgCollisionHandler(SimpleOrganism *org, SimpleResource *res) {
       using OrgBody_t = Body<Circle>;
       using ResBody_t = Body<Circle>;
       OrgBody_t *org_body = org->GetBodyPtr();
       ResBody_t *res_body = res->GetBodyPtr();
+      // Only resources with an entity ID are ours to be eaten (e.g. not ghosts from another
+      // shard; their own shard settles who eats them).
+      if (res->GetEntityID() == 0) return;
+      const uint32_t consumer_id = GetConsumerID(org);
+      if (consumer_id == 0) return;
       // If an organism manages to eat a resource and they are not already linked, add a link
       // org_body---->res_body.
-      if (random_ptr->P(org->GetResourceConsumptionProb(*res))) {
+      CounterRandom consume_rng(rng_seed, update_count, RNG_PURPOSE::CONSUMPTION, consumer_id, res->GetEntityID());
+      if (consume_rng.P(org->GetResourceConsumptionProb(*res))) {
         if (!org_body->IsLinked(*res_body)) {
           double strength;
           // TODO: repeated math -- can speed up by having a collision info struct.
@@ -169,113 +470,193 @@ class PopulationManager_SimplePhysics {
       }
     }
 
+    // Shuffle the first max_count entries of v into a random order (like emp::Shuffle).
+    template <typename T>
+    static void Shuffle(CounterRandom &rng, emp::vector<T> &v, int max_count) {
+      for (int i = 0; i < max_count; i++) {
+        const int pos = rng.GetInt(i, (int) v.size());
+        if (pos == i) continue;
+        std::swap(v[i], v[pos]);
+      }
+    }
+
+    int NumChunks(int count) const { return (count + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+    // Call fun(chunk, first, last) for every chunk of [0, count), in parallel.
+    template <typename FUN>
+    void ForEachChunk(int count, FUN fun) {
+      thread_pool->ParallelFor(NumChunks(count), [count, &fun](int chunk) {
+        const int first = chunk * CHUNK_SIZE;
+        fun(chunk, first, std::min(count, first + CHUNK_SIZE));
+      });
+    }
+
+    // Keep only the entities whose fate is ALIVE, in their original order.
+    template <typename T>
+    void Compact(emp::vector<T*> &entities, const emp::vector<FATE> &fates, emp::vector<T*> &scratch) {
+      const int count = (int) entities.size();
+      const int num_chunks = NumChunks(count);
+      chunk_offsets.assign(num_chunks + 1, 0);
+      ForEachChunk(count, [this, &fates](int chunk, int first, int last) {
+        int kept = 0;
+        for (int i = first; i < last; i++) kept += (fates[i] == FATE::ALIVE);
+        chunk_offsets[chunk + 1] = kept;
+      });
+      for (int chunk = 0; chunk < num_chunks; chunk++) chunk_offsets[chunk + 1] += chunk_offsets[chunk];
+      scratch.resize(chunk_offsets[num_chunks]);
+      ForEachChunk(count, [this, &entities, &fates, &scratch](int chunk, int first, int last) {
+        int pos = chunk_offsets[chunk];
+        for (int i = first; i < last; i++) {
+          if (fates[i] == FATE::ALIVE) scratch[pos++] = entities[i];
+        }
+      });
+      std::swap(entities, scratch);
+    }
+
     // Progress time by one step.
     void Update() {
+      update_count++;
       physics.Update();
-      // Place for new organisms.
-      emp::vector<Org_t*> new_organisms;
       ////////////////////////////////////
       // Manage the resources.
       ////////////////////////////////////
-      int cur_size = GetNumResources();
-      int cur_id = 0;
-      while (cur_id < cur_size) {
-        Resource_t *resource = resources[cur_id];
-        // Evaluate the resource.
-        resource->Evaluate();
-        // Remove resources with no body.
-        if (!resource->HasBody()) {
-          delete resource;
-          cur_size--;
-          resources[cur_id] = resources[cur_size];
-          continue;
-        }
-        // Resource has body, proceed.
-        // Handle resource consumption.
-        // TODO: Is this the best place for this interaction?
-        auto consumption_links = resource->GetBodyPtr()->GetLinksToByType(BODY_LINK_TYPE::CONSUME_RESOURCE);
-        if ((int) consumption_links.size() > 0) {
-          // Find the strongest link!
-          auto *max_link = consumption_links[0];
-          for (auto *link : consumption_links) {
-            if (link->link_strength > max_link->link_strength) max_link = link;
-          }
-          // Feed resource to the strongest link.
-          //  * When an organism eats a resource:
-          // TODO: This bit is a little gross, but not sure if there's a better way to do it?
-          if (max_link->from->GetPhysicsBodyTypeID() == ORG_PHYSICS_BODY_TYPE_ID) {
-            SimpleOrganism *org = static_cast<Body<Circle>*>(max_link->from)->GetOwnerPtr<SimpleOrganism, ORG_PHYSICS_BODY_TYPE_ID>();
-            org->ConsumeResource(*resource);
-            delete resource;
-            cur_size--;
-            resources[cur_id] = resources[cur_size];
+      int num_resources = GetNumResources();
+      resource_fates.resize(num_resources);
+      resource_consumers.resize(num_resources);
+      // Mark: which resources are gone, eaten (and by whom), or too old?
+      ForEachChunk(num_resources, [this](int chunk, int first, int last) {
+        for (int i = first; i < last; i++) {
+          Resource_t *resource = resources[i];
+          resource_consumers[i] = nullptr;
+          // Resources with no body (or whose body is slated for destruction) are removed.
+          if (!resource->HasBody() || resource->GetBody().GetDestroyFlag()) {
+            resource_fates[i] = FATE::DEAD;
             continue;
-          } // TODO: else { delete all links }
+          }
+          resource->IncAge();
+          // Handle resource consumption: the strongest consumption link gets fed.
+          auto consumption_links = resource->GetBodyPtr()->GetLinksToByType(BODY_LINK_TYPE::CONSUME_RESOURCE);
+          if ((int) consumption_links.size() > 0) {
+            auto *max_link = consumption_links[0];
+            for (auto *link : consumption_links) {
+              if (link->link_strength > max_link->link_strength) max_link = link;
+            }
+            // TODO: This bit is a little gross, but not sure if there's a better way to do it?
+            if (max_link->from->GetPhysicsBodyTypeID() == ORG_PHYSICS_BODY_TYPE_ID) {
+              resource_consumers[i] = static_cast<Body<Circle>*>(max_link->from)->GetOwnerPtr<SimpleOrganism, ORG_PHYSICS_BODY_TYPE_ID>();
+              resource_fates[i] = FATE::CONSUMED;
+              continue;
+            } // TODO: else { delete all links }
+          }
+          // Check resource aging
+          resource_fates[i] = (resource->GetAge() > max_resource_age) ? FATE::AGED : FATE::ALIVE;
         }
-        // Check resource aging
-        if (resource->GetAge() > max_resource_age) {
-          delete resource;
-          cur_size--;
-          resources[cur_id] = resources[cur_size];
-          continue;
+      });
+      // Apply: feed consumers (in resource order) and delete everything that is not alive.
+      for (int i = 0; i < num_resources; i++) {
+        if (resource_fates[i] == FATE::ALIVE) continue;
+        if (resource_fates[i] == FATE::CONSUMED) FeedConsumer(resource_consumers[i], *resources[i]);
+        if (event_log) {
+          const uint32_t res_id = resources[i]->GetEntityID();
+          if (resource_fates[i] == FATE::CONSUMED) event_log->ResourceConsumed(res_id, GetConsumerID(resource_consumers[i]));
+          else if (resource_fates[i] == FATE::AGED) event_log->ResourceAged(res_id);
+          else event_log->ResourceRemoved(res_id);
         }
-        // Add some noise to movement
-        resource->GetBody().IncSpeed(Angle(random_ptr->GetDouble() * (2.0 * emp::PI)).GetPoint(movement_noise));
-        cur_id++;
+        delete resources[i];
       }
-      resources.resize(cur_size);
+      Compact(resources, resource_fates, resource_scratch);
+      // Resources that survived get movement noise (but not the ones about to flow in).
+      const int num_noisy_resources = GetNumResources();
       // Pump resources (at inflow rate) in as necessary to max capacity.
       for (int i = 0; (i < resource_in_flow_rate) && (GetNumResources() < max_resource_count); i++) {
         emp_assert((physics.GetWidth() > resource_radius * 2.0) && (physics.GetHeight() > resource_radius * 2.0));
-        Point<double> res_loc(random_ptr->GetDouble(resource_radius, physics.GetWidth() - resource_radius),
-                                   random_ptr->GetDouble(resource_radius, physics.GetHeight() - resource_radius));
+        CounterRandom placement_rng(rng_seed, update_count, RNG_PURPOSE::RESOURCE_PLACEMENT, (uint32_t) i);
+        const double min_x = std::max(resource_radius, resource_min_x);
+        const double max_x = std::min(physics.GetWidth() - resource_radius, resource_max_x);
+        Point<double> res_loc(placement_rng.GetDouble(min_x, max_x),
+                                   placement_rng.GetDouble(resource_radius, physics.GetHeight() - resource_radius));
         Resource_t *new_resource = new Resource_t(Circle(res_loc, resource_radius));
         new_resource->SetValue(resource_value);
         // TODO: make the below values not magic numbers.
         new_resource->SetColorID(180);
         new_resource->GetBodyPtr()->SetMass(1);
         AddResource(new_resource);
+        if (event_log) event_log->ResourceSpawned(new_resource->GetEntityID(), resource_value);
       }
       ////////////////////////////////////
       // Manage the population.
       ////////////////////////////////////
-      cur_size = GetSize();
-      cur_id = 0;
-      while (cur_id < cur_size) {
-        Org_t *org = population[cur_id];
-        // Evaluate this organism.
-        org->Evaluate();
-        // Check on this organism's body.
-        if (!org->HasBody()) {
-          delete org;
-          cur_size--;
-          population[cur_id] = population[cur_size];
-          continue;
+      const int num_orgs = GetSize();
+      org_fates.resize(num_orgs);
+      chunk_births.resize(NumChunks(num_orgs));
+      if (event_log) chunk_parents.resize(NumChunks(num_orgs));
+      // Mark: which organisms are gone? Everyone else may reproduce into their chunk's buffer.
+      ForEachChunk(num_orgs, [this](int chunk, int first, int last) {
+        emp::vector<Org_t*> &births = chunk_births[chunk];
+        births.resize(0);
+        if (event_log) chunk_parents[chunk].resize(0);
+        for (int i = first; i < last; i++) {
+          Org_t *org = population[i];
+          if (!org->HasBody() || org->GetBody().GetDestroyFlag()) {
+            org_fates[i] = FATE::DEAD;
+            continue;
+          }
+          org_fates[i] = FATE::ALIVE;
+          // Reproduction. Organisms that have sufficient energy and are not too stressed may reproduce.
+          if (!org->GetBodyPtr()->ExceedsStressThreshold() && org->GetEnergy() >= cost_of_repro) {
+            CounterRandom repro_rng(rng_seed, update_count, RNG_PURPOSE::REPRODUCTION, org->GetEntityID());
+            births.push_back(org->Reproduce(&repro_rng, point_mutation_rate, cost_of_repro));
+            if (event_log) chunk_parents[chunk].push_back(org);
+          }
         }
-        // Organism has a body, proceed.
-        // Reproduction. Organisms that have sufficient energy and are not too stressed may reproduce.
-        if (!org->GetBodyPtr()->ExceedsStressThreshold() && org->GetEnergy() >= cost_of_repro) {
-          auto *baby_org = org->Reproduce(random_ptr, point_mutation_rate, cost_of_repro);
-          new_organisms.push_back(baby_org);
+      });
+      // Apply: delete the dead, then compact.
+      for (int i = 0; i < num_orgs; i++) {
+        if (org_fates[i] == FATE::ALIVE) continue;
+        if (event_log) event_log->OrgPopped(population[i]->GetEntityID());
+        DeleteOrg(population[i]);
+      }
+      Compact(population, org_fates, org_scratch);
+      // Merge births in chunk order.
+      emp::vector<Org_t*> new_organisms;
+      for (int chunk = 0; chunk < NumChunks(num_orgs); chunk++) {
+        new_organisms.insert(new_organisms.end(), chunk_births[chunk].begin(), chunk_births[chunk].end());
+      }
+      if (event_log) {
+        // Offspring get their entity IDs from AddOrg (below), in this order.
+        uint32_t offspring_id = next_entity_id;
+        for (int chunk = 0; chunk < NumChunks(num_orgs); chunk++) {
+          for (int i = 0; i < (int) chunk_births[chunk].size(); i++) {
+            Org_t *parent = chunk_parents[chunk][i];
+            event_log->OrgBorn(parent->GetEntityID(), offspring_id, cost_of_repro, parent->genome, chunk_births[chunk][i]->genome);
+            offspring_id += entity_id_stride;
+          }
         }
-        // Add some noise to movement.
-        org->GetBody().IncSpeed(Angle(random_ptr->GetDouble() * (2.0 * emp::PI)).GetPoint(movement_noise));
-        cur_id++;
       }
-      population.resize(cur_size);
       // Cull the population to make room for new offspring.
       int total_size = (int)(population.size() + new_organisms.size());
-      if (total_size > max_pop_size) {
+      const int pop_cap = GetPopCap(total_size);
+      if (total_size > pop_cap) {
         // Cull population to make room for new organisms.
-        int new_size = ((int) population.size()) - (total_size - max_pop_size);
-        emp::Shuffle<Org_t *>(*random_ptr, population, new_size);
+        int new_size = std::max(0, ((int) population.size()) - (total_size - pop_cap));
+        CounterRandom cull_rng(rng_seed, update_count, RNG_PURPOSE::CULL, 0);
+        Shuffle<Org_t *>(cull_rng, population, new_size);
         for (int i = new_size; i < (int) population.size(); i++) {
-          delete population[i];
+          if (event_log) event_log->OrgCulled(population[i]->GetEntityID());
+          DeleteOrg(population[i]);
         }
         population.resize(new_size);
       }
+      // Add some noise to movement (surviving resources and organisms, all at once).
+      noise.Clear();
+      for (int i = 0; i < num_noisy_resources; i++) noise.Add(resources[i]->GetEntityID());
+      for (auto *org : population) noise.Add(org->GetEntityID());
+      noise.Generate(rng_seed, update_count, movement_noise);
+      for (int i = 0; i < num_noisy_resources; i++) resources[i]->GetBody().IncSpeed(noise.GetKick(i));
+      for (int i = 0; i < GetSize(); i++) population[i]->GetBody().IncSpeed(noise.GetKick(num_noisy_resources + i));
       // Add new organisms to the population.
       for (auto *new_organism : new_organisms) AddOrg(new_organism);
+      if (event_log) event_log->EndUpdate(update_count, population, resources);
     }
 };
 
@@ -0,0 +1,71 @@
+/*
+  random/BulkNoise.h
+    Defines BulkNoise, which generates Brownian-motion velocity kicks for many bodies at once.
+
+    Rather than building an Angle and calling GetPoint() (two trig calls) body by body,
+    collect the entity IDs of every body that needs a kick, then Generate():
+      1. draws one uniform per body with CounterRandom::FillUniform (keyed by entity id, so
+         each body gets the same kick no matter where it sits in the list), and
+      2. turns each draw into a direction by table lookup in emp::sin_chart_1K/cos_chart_1K
+         (256 directions; plenty for noise).
+    Both passes are straight loops over flat arrays, so the compiler can vectorize them. The
+    caller then applies the kicks in one pass over its bodies.
+*/
+
+#ifndef BULK_NOISE_H
+#define BULK_NOISE_H
+
+#include <cstdint>
+
+#include "geometry/Angle2D.h"
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+#include "CounterRandom.h"
+
+class BulkNoise {
+  private:
+    emp::vector<uint32_t> entity_ids;
+    emp::vector<double> uniforms;
+    emp::vector<double> kick_x;
+    emp::vector<double> kick_y;
+
+  public:
+    BulkNoise() { ; }
+
+    int GetSize() const { return (int) entity_ids.size(); }
+
+    void Clear() { entity_ids.resize(0); }
+
+    // Queue up a body; returns its index for GetKick.
+    int Add(uint32_t entity_id) {
+      entity_ids.push_back(entity_id);
+      return GetSize() - 1;
+    }
+
+    // Generate a kick of length magnitude (in a uniformly random direction) for every body.
+    void Generate(uint32_t seed, uint32_t update, double magnitude) {
+      const int count = GetSize();
+      uniforms.resize(count);
+      kick_x.resize(count);
+      kick_y.resize(count);
+      CounterRandom::FillUniform(seed, update, RNG_PURPOSE::MOVEMENT_NOISE, entity_ids.data(), count, uniforms.data());
+      // Charts are scaled by 1024. As in Angle::GetPoint, x comes from sin and y from cos.
+      const double scale = magnitude / 1024.0;
+      const double *u = uniforms.data();
+      double *x = kick_x.data();
+      double *y = kick_y.data();
+      for (int i = 0; i < count; i++) {
+        const int dir = ((int) (u[i] * 256.0)) & 255;
+        x[i] = emp::sin_chart_1K[dir] * scale;
+        y[i] = emp::cos_chart_1K[dir] * scale;
+      }
+    }
+
+    emp::Point<double> GetKick(int i) const {
+      emp_assert(i >= 0 && i < (int) kick_x.size());
+      return emp::Point<double>(kick_x[i], kick_y[i]);
+    }
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+  random/CounterRandom.h
+    Counter-based random numbers (Philox4x32-10) keyed by who is asking and why.
+
+    Every draw is a pure function of (seed, update, purpose, entity id, other id, draw index),
+    so there is no generator state to share between threads, and results do not depend on
+    the order in which bodies happen to be processed. A CounterRandom object is just a
+    cursor into one such stream; it offers the parts of the emp::Random interface we use
+    (GetDouble, GetInt, GetUInt, P), so code templated on the random type (e.g.
+    SimpleOrganism::Reproduce) takes either.
+
+    FillUniform() generates the first double of many entities' streams at once. It is a
+    straight loop over arrays with no branches, so the compiler can vectorize it; its
+    output matches CounterRandom(...).GetDouble() for the same key.
+*/
+
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include <cstdint>
+
+#include "tools/assert.h"
+
+// What a stream is used for. Streams with different purposes never overlap.
+enum class RNG_PURPOSE : uint32_t {
+  MOVEMENT_NOISE = 1,
+  CONSUMPTION,
+  REPRODUCTION,
+  RESOURCE_PLACEMENT,
+  CULL
+};
+
+class CounterRandom {
+  private:
+    static constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+    static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+    static constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+    static constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+
+    uint32_t key[2];      // (seed, purpose)
+    uint32_t ctr[4];      // (block index, entity id, other id, update)
+    uint32_t block[4];    // Output of the current block.
+    int block_pos;        // Next unused word in block.
+
+    void NextBlock() {
+      Philox(ctr, key, block);
+      ctr[0]++;
+      block_pos = 0;
+    }
+
+  public:
+    // Philox4x32 with 10 rounds: out = f(counter, key).
+    static inline void Philox(const uint32_t in_ctr[4], const uint32_t in_key[2], uint32_t out[4]) {
+      uint32_t c0 = in_ctr[0], c1 = in_ctr[1], c2 = in_ctr[2], c3 = in_ctr[3];
+      uint32_t k0 = in_key[0], k1 = in_key[1];
+      for (int round = 0; round < 10; round++) {
+        const uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        const uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        const uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        const uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t) p1;
+        c3 = (uint32_t) p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+      }
+      out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    // Two 32-bit words -> a double in [0, 1) with 53 bits of precision.
+    static inline double ToDouble(uint32_t hi, uint32_t lo) {
+      return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0 / 9007199254740992.0);
+    }
+
+    CounterRandom(uint32_t seed, uint32_t update, RNG_PURPOSE purpose, uint32_t entity_id, uint32_t other_id = 0)
+      : block_pos(4)
+    {
+      key[0] = seed;
+      key[1] = (uint32_t) purpose;
+      ctr[0] = 0;
+      ctr[1] = entity_id;
+      ctr[2] = other_id;
+      ctr[3] = update;
+    }
+
+    uint32_t GetUInt() {
+      if (block_pos == 4) NextBlock();
+      return block[block_pos++];
+    }
+
+    // Uniform double in [0, 1).
+    double GetDouble() {
+      if (block_pos > 2) NextBlock();
+      const double value = ToDouble(block[block_pos], block[block_pos + 1]);
+      block_pos += 2;
+      return value;
+    }
+    double GetDouble(double max) { return GetDouble() * max; }
+    double GetDouble(double min, double max) { return min + GetDouble() * (max - min); }
+
+    uint32_t GetUInt(uint32_t max) { return (uint32_t) GetDouble(max); }
+    int GetInt(int max) { return (int) GetDouble(max); }
+    int GetInt(int min, int max) { return min + GetInt(max - min); }
+
+    bool P(double p) { return GetDouble() < p; }
+
+    // out[i] = CounterRandom(seed, update, purpose, entity_ids[i]).GetDouble(), for all i.
+    static void FillUniform(uint32_t seed, uint32_t update, RNG_PURPOSE purpose,
+                            const uint32_t *entity_ids, int count, double *out) {
+      const uint32_t in_key[2] = { seed, (uint32_t) purpose };
+      for (int i = 0; i < count; i++) {
+        const uint32_t in_ctr[4] = { 0, entity_ids[i], 0, update };
+        uint32_t words[4];
+        Philox(in_ctr, in_key, words);
+        out[i] = ToDouble(words[0], words[1]);
+      }
+    }
+};
+
+#endif
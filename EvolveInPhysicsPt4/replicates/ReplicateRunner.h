@@ -0,0 +1,87 @@
+/*
+  replicates/ReplicateRunner.h
+    Defines ReplicateRunner, which runs many independent replicates of an experiment in one
+    process and summarizes them.
+
+    Run(first_seed, num_replicates, fun) calls fun(seed) for seeds first_seed,
+    first_seed + 1, ... on a WorkStealingPool. fun builds and runs its own world (its own
+    emp::Random, physics and population manager) and returns one value per column. As each
+    replicate finishes, its row is written (and flushed) to the output stream, so a run
+    that dies part way keeps everything finished so far, and is folded into a RunningStats
+    per column. Rows come out in the order replicates finish; the seed column says which is
+    which. PrintSummary reports mean, standard deviation and 95% CI over replicates.
+
+    Anything fun reads from outside (the config, say) is shared between threads and must
+    only be read.
+*/
+
+#ifndef REPLICATE_RUNNER_H
+#define REPLICATE_RUNNER_H
+
+#include <iostream>
+#include <string>
+#include <mutex>
+#include <functional>
+
+#include "../parallel/WorkStealingPool.h"
+#include "RunningStats.h"
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+class ReplicateRunner {
+  public:
+    using row_t = emp::vector<double>;
+    using replicate_fun_t = std::function<row_t(int)>;
+
+  private:
+    emp::vector<std::string> columns;
+    emp::vector<RunningStats> stats;
+    std::ostream &out;
+    std::string delimiter;
+    WorkStealingPool pool;
+    std::mutex mutex;         // Guards out and stats.
+    int finished;
+
+  public:
+    ReplicateRunner(const emp::vector<std::string> &_columns, std::ostream &_out, int num_threads,
+                    const std::string &_delimiter = ",")
+      : columns(_columns), stats(_columns.size()), out(_out), delimiter(_delimiter), pool(num_threads),
+        finished(0)
+    { ; }
+
+    int GetNumThreads() const { return pool.GetNumThreads(); }
+    int GetNumFinished() const { return finished; }
+    int GetStealCount() const { return pool.GetStealCount(); }
+    const RunningStats & GetStats(int column) const { return stats[column]; }
+
+    void Run(int first_seed, int num_replicates, const replicate_fun_t &fun) {
+      out << "seed";
+      for (const auto &column : columns) out << delimiter << column;
+      out << std::endl;
+      pool.Run(num_replicates, [this, first_seed, &fun](int replicate) {
+        const int seed = first_seed + replicate;
+        const row_t row = fun(seed);
+        emp_assert(row.size() == columns.size());
+        std::lock_guard<std::mutex> guard(mutex);
+        out << seed;
+        for (double value : row) out << delimiter << value;
+        out << std::endl;
+        for (int c = 0; c < (int) row.size(); c++) stats[c].Add(row[c]);
+        finished++;
+      });
+    }
+
+    void PrintSummary(std::ostream &os) const {
+      os << "column" << delimiter << "replicates" << delimiter << "mean" << delimiter << "stddev"
+         << delimiter << "ci95" << delimiter << "min" << delimiter << "max" << "\n";
+      for (int c = 0; c < (int) columns.size(); c++) {
+        os << columns[c] << delimiter << stats[c].GetCount() << delimiter << stats[c].GetMean()
+           << delimiter << stats[c].GetStdDev() << delimiter << stats[c].GetCI95()
+           << delimiter << stats[c].GetMin() << delimiter << stats[c].GetMax() << "\n";
+      }
+      os.flush();
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+  replicates/RunningStats.h
+    Defines RunningStats, which keeps the count, mean, variance, min and max of a stream of
+    values without storing them (Welford's method), and gives a 95% confidence interval for
+    the mean using Student's t distribution.
+*/
+
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+class RunningStats {
+  private:
+    int count;
+    double mean;
+    double sum_sq_diff;     // Sum of squared differences from the current mean.
+    double min_value;
+    double max_value;
+
+    // Two-sided 95% critical values of t for 1-30 degrees of freedom.
+    static double GetT95(int df) {
+      static const double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+      if (df <= 30) return table[df - 1];
+      if (df <= 40) return 2.021;
+      if (df <= 60) return 2.000;
+      if (df <= 120) return 1.980;
+      return 1.960;
+    }
+
+  public:
+    RunningStats()
+      : count(0), mean(0.0), sum_sq_diff(0.0),
+        min_value(std::numeric_limits<double>::max()), max_value(std::numeric_limits<double>::lowest())
+    { ; }
+
+    void Add(double value) {
+      count++;
+      const double diff = value - mean;
+      mean += diff / count;
+      sum_sq_diff += diff * (value - mean);
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+    }
+
+    int GetCount() const { return count; }
+    double GetMean() const { return mean; }
+    double GetMin() const { return min_value; }
+    double GetMax() const { return max_value; }
+    // Sample variance (0 until there are two values).
+    double GetVariance() const { return (count > 1) ? sum_sq_diff / (count - 1) : 0.0; }
+    double GetStdDev() const { return std::sqrt(GetVariance()); }
+    // Half-width of the 95% confidence interval for the mean.
+    double GetCI95() const {
+      if (count < 2) return 0.0;
+      return GetT95(count - 1) * GetStdDev() / std::sqrt((double) count);
+    }
+};
+
+#endif
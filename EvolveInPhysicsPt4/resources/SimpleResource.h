@@ -16,11 +16,13 @@ class SimpleResource {
     double value;
     double age;
     bool has_body;
+    uint32_t entity_id;       // Assigned by the population manager; keys this resource's random streams.
 
   public:
     SimpleResource(const emp::Circle &_p, double value = 1.0) :
       age(0.0),
-      has_body(false)
+      has_body(false),
+      entity_id(0)
     {
       AttachBody(new Body_t(_p));
       //body->SetDetachOnRepro(true);
@@ -32,7 +34,8 @@ class SimpleResource {
     SimpleResource(const SimpleResource &other) :
         value(other.GetValue()),
         age(0.0),
-        has_body(other.HasBody())
+        has_body(other.HasBody()),
+        entity_id(0)
     {
       if (has_body) {
         const emp::Circle circle(other.GetConstBody().GetConstShape());
@@ -57,7 +60,9 @@ class SimpleResource {
     const Body_t & GetConstBody() const { emp_assert(has_body); return *body; }
     bool HasBody() const { return has_body; }
     void FlagBodyDestruction() { has_body = false; }
+    uint32_t GetEntityID() const { return entity_id; }
 
+    void SetEntityID(uint32_t id) { entity_id = id; }
     void SetValue(double value) { this->value = value; }
     void SetAge(double age) { this->age = age; }
     int IncAge() { return ++age; }
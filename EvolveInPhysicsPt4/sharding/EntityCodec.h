@@ -0,0 +1,88 @@
+/*
+  sharding/EntityCodec.h
+    Writes organisms and resources (genome plus body state) into shard messages and rebuilds
+    them on the other side.
+
+    Rebuilt entities have no entity ID and no links; whoever adds them to a population
+    manager gives them a new ID. Other organism types can be sharded by providing their own
+    Encode/Decode overloads.
+*/
+
+#ifndef SHARD_ENTITY_CODEC_H
+#define SHARD_ENTITY_CODEC_H
+
+#include "physics/Body2D.h"
+
+#include "../organisms/SimpleOrganism.h"
+#include "../resources/SimpleResource.h"
+#include "../../shared/serialize/Bytes.h"
+
+// Shape, velocity and mass (everything the physics needs to carry on with a body).
+template <typename BODY>
+void EncodeBody(ByteWriter &writer, const BODY &body) {
+  const emp::Circle &circle = body.GetConstShape();
+  writer.Write(circle.GetCenter().GetX()).Write(circle.GetCenter().GetY()).Write(circle.GetRadius());
+  writer.Write(body.GetVelocity().GetX()).Write(body.GetVelocity().GetY()).Write(body.GetMass());
+}
+
+struct BodyState {
+  emp::Circle circle;
+  emp::Point<double> velocity;
+  double mass;
+
+  BodyState(ByteReader &reader) : circle(emp::Point<double>(0.0, 0.0), 0.0) {
+    const double x = reader.Read<double>();
+    const double y = reader.Read<double>();
+    const double radius = reader.Read<double>();
+    circle = emp::Circle(emp::Point<double>(x, y), radius);
+    const double vx = reader.Read<double>();
+    const double vy = reader.Read<double>();
+    velocity = emp::Point<double>(vx, vy);
+    mass = reader.Read<double>();
+  }
+
+  template <typename BODY>
+  void Apply(BODY &body) const {
+    body.SetVelocity(velocity);
+    body.SetMass(mass);
+  }
+};
+
+inline void Encode(ByteWriter &writer, const SimpleOrganism &org) {
+  EncodeBody(writer, org.GetConstBody());
+  writer.Write(org.genome);
+  writer.Write(org.GetEnergy()).Write(org.GetResourcesCollected()).Write(org.GetOffspringCount());
+  writer.Write(org.GetBirthTime()).Write(org.GetMembraneStrength()).Write(org.GetDetachOnBirth());
+}
+
+inline void Decode(ByteReader &reader, SimpleOrganism *&org) {
+  const BodyState body_state(reader);
+  emp::BitVector genome(0);
+  reader.Read(genome);
+  org = new SimpleOrganism(body_state.circle, genome.GetSize());
+  org->genome = genome;
+  body_state.Apply(org->GetBody());
+  org->SetEnergy(reader.Read<double>());
+  org->SetResourcesCollected(reader.Read<int>());
+  org->SetOffspringCount(reader.Read<int>());
+  org->SetBirthTime(reader.Read<double>());
+  org->SetMembraneStrength(reader.Read<double>());
+  org->SetDetachOnBirth(reader.Read<bool>());
+  org->SetColorID();
+}
+
+inline void Encode(ByteWriter &writer, const SimpleResource &res) {
+  EncodeBody(writer, res.GetConstBody());
+  writer.Write(res.GetValue()).Write(res.GetAge()).Write(res.GetConstBody().GetColorID());
+}
+
+inline void Decode(ByteReader &reader, SimpleResource *&res) {
+  const BodyState body_state(reader);
+  res = new SimpleResource(body_state.circle);
+  body_state.Apply(res->GetBody());
+  res->SetValue(reader.Read<double>());
+  res->SetAge(reader.Read<double>());
+  res->SetColorID(reader.Read<decltype(res->GetConstBody().GetColorID())>());
+}
+
+#endif
@@ -0,0 +1,216 @@
+/*
+  sharding/Transport.h
+    Defines Transport, how shards of one world pass messages to each other, and
+    UnixSocketTransport, which connects processes on one machine with Unix domain sockets.
+
+    * Send() only queues a message; it never waits on the peer. Receive(peer) waits for the
+      next message from that peer, writing out queued messages while it waits. So shards
+      can all send first and receive second without deadlocking, however big the messages.
+    * Messages from one peer arrive in the order they were sent.
+    * UnixSocketTransport::Launch(num_ranks, shard_main) forks num_ranks - 1 children, wires
+      every pair of processes together with a socketpair, and runs shard_main(transport) in
+      each process (the calling process is rank 0). It returns once every shard is done.
+
+    A transport that loses a peer cannot recover, so errors print a message and exit.
+*/
+
+#ifndef SHARD_TRANSPORT_H
+#define SHARD_TRANSPORT_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+class Transport {
+  public:
+    virtual ~Transport() { ; }
+
+    virtual int GetRank() const = 0;
+    virtual int GetNumRanks() const = 0;
+    // Queue a message for peer.
+    virtual void Send(int peer, const std::string &message) = 0;
+    // Wait for the next message from peer.
+    virtual std::string Receive(int peer) = 0;
+};
+
+class UnixSocketTransport : public Transport {
+  private:
+    struct Peer {
+      int fd;                 // -1 for ourselves.
+      std::string outbox;     // Framed messages not yet written.
+      size_t sent;            // How much of outbox has been written.
+      std::string inbox;      // Bytes read but not yet returned by Receive.
+
+      Peer() : fd(-1), sent(0) { ; }
+    };
+
+    int rank;
+    emp::vector<Peer> peers;
+
+    static void Fail(const std::string &what) {
+      std::cerr << "UnixSocketTransport: " << what << " (" << std::strerror(errno) << ")" << std::endl;
+      std::exit(1);
+    }
+
+    // Pull one complete message out of an inbox, if there is one.
+    static bool PopMessage(std::string &inbox, std::string &message) {
+      uint32_t length;
+      if (inbox.size() < sizeof(length)) return false;
+      std::memcpy(&length, inbox.data(), sizeof(length));
+      if (inbox.size() < sizeof(length) + length) return false;
+      message.assign(inbox, sizeof(length), length);
+      inbox.erase(0, sizeof(length) + length);
+      return true;
+    }
+
+    // Write whatever the sockets will take and read whatever has arrived. Waits for at least
+    // one of those to happen unless wait is false.
+    void Pump(bool wait) {
+      emp::vector<pollfd> poll_fds;
+      emp::vector<int> poll_peers;
+      for (int p = 0; p < (int) peers.size(); p++) {
+        if (peers[p].fd < 0) continue;
+        pollfd entry;
+        entry.fd = peers[p].fd;
+        entry.events = POLLIN;
+        if (peers[p].sent < peers[p].outbox.size()) entry.events |= POLLOUT;
+        entry.revents = 0;
+        poll_fds.push_back(entry);
+        poll_peers.push_back(p);
+      }
+      if (poll_fds.size() == 0) return;
+      if (poll(poll_fds.data(), poll_fds.size(), wait ? -1 : 0) < 0) {
+        if (errno == EINTR) return;
+        Fail("poll failed");
+      }
+      char chunk[65536];
+      for (int i = 0; i < (int) poll_fds.size(); i++) {
+        Peer &peer = peers[poll_peers[i]];
+        if (poll_fds[i].revents & POLLOUT) {
+          const ssize_t count = send(peer.fd, peer.outbox.data() + peer.sent, peer.outbox.size() - peer.sent, MSG_NOSIGNAL);
+          if (count < 0 && errno != EAGAIN && errno != EINTR) Fail("write failed");
+          if (count > 0) peer.sent += count;
+          if (peer.sent == peer.outbox.size()) { peer.outbox.clear(); peer.sent = 0; }
+        }
+        if (poll_fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+          const ssize_t count = read(peer.fd, chunk, sizeof(chunk));
+          if (count < 0 && errno != EAGAIN && errno != EINTR) Fail("read failed");
+          if (count == 0 && wait) {
+            // Peer hung up. Only a problem if we were still expecting something from it.
+            close(peer.fd);
+            peer.fd = -1;
+          }
+          if (count > 0) peer.inbox.append(chunk, count);
+        }
+      }
+    }
+
+  public:
+    // fds[p] is the connected socket to rank p (and -1 at fds[rank]).
+    UnixSocketTransport(int _rank, const emp::vector<int> &fds) : rank(_rank), peers(fds.size()) {
+      emp_assert(rank >= 0 && rank < (int) fds.size());
+      for (int p = 0; p < (int) fds.size(); p++) {
+        peers[p].fd = fds[p];
+        if (fds[p] >= 0) fcntl(fds[p], F_SETFL, fcntl(fds[p], F_GETFL) | O_NONBLOCK);
+      }
+    }
+    UnixSocketTransport(const UnixSocketTransport &) = delete;
+    UnixSocketTransport & operator=(const UnixSocketTransport &) = delete;
+
+    // Finish writing anything still queued, then hang up.
+    ~UnixSocketTransport() {
+      for (auto &peer : peers) {
+        while (peer.fd >= 0 && peer.sent < peer.outbox.size()) Pump(true);
+      }
+      for (auto &peer : peers) {
+        if (peer.fd >= 0) close(peer.fd);
+      }
+    }
+
+    int GetRank() const { return rank; }
+    int GetNumRanks() const { return (int) peers.size(); }
+
+    void Send(int peer, const std::string &message) {
+      emp_assert(peer != rank && peer >= 0 && peer < GetNumRanks());
+      const uint32_t length = (uint32_t) message.size();
+      peers[peer].outbox.append(reinterpret_cast<const char *>(&length), sizeof(length));
+      peers[peer].outbox.append(message);
+      Pump(false);
+    }
+
+    std::string Receive(int peer) {
+      emp_assert(peer != rank && peer >= 0 && peer < GetNumRanks());
+      std::string message;
+      while (!PopMessage(peers[peer].inbox, message)) {
+        if (peers[peer].fd < 0) {
+          errno = ECONNRESET;
+          Fail("lost connection to a peer");
+        }
+        Pump(true);
+      }
+      return message;
+    }
+
+    // Run shard_main in num_ranks processes connected to each other. Returns 0 if every shard
+    // returned 0.
+    static int Launch(int num_ranks, const std::function<int(Transport &)> &shard_main) {
+      emp_assert(num_ranks > 0);
+      // fds[i][j] is rank i's end of the socket connecting ranks i and j.
+      emp::vector<emp::vector<int>> fds(num_ranks, emp::vector<int>(num_ranks, -1));
+      for (int i = 0; i < num_ranks; i++) {
+        for (int j = i + 1; j < num_ranks; j++) {
+          int pair[2];
+          if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) Fail("socketpair failed");
+          fds[i][j] = pair[0];
+          fds[j][i] = pair[1];
+        }
+      }
+      std::cout.flush();
+      std::cerr.flush();
+      emp::vector<pid_t> children;
+      int my_rank = 0;
+      for (int r = 1; r < num_ranks; r++) {
+        const pid_t pid = fork();
+        if (pid < 0) Fail("fork failed");
+        if (pid == 0) { my_rank = r; break; }
+        children.push_back(pid);
+      }
+      // Close every socket end that is not ours.
+      for (int i = 0; i < num_ranks; i++) {
+        if (i == my_rank) continue;
+        for (int fd : fds[i]) if (fd >= 0) close(fd);
+      }
+      int status = 0;
+      {
+        UnixSocketTransport transport(my_rank, fds[my_rank]);
+        status = shard_main(transport);
+      }
+      if (my_rank != 0) {
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(status);
+      }
+      for (pid_t child : children) {
+        int child_status = 0;
+        waitpid(child, &child_status, 0);
+        if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) status = 1;
+      }
+      return status;
+    }
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+  stats/PopulationStats.h
+    Defines PopulationStats, the stats both the native drivers and the web interface report
+    for a Pt4 population (see POP_STAT for the list). Sample(popM) works all of the
+    per-organism ones out in a single (optionally parallel) pass over the population, as one
+    fused reducer (see stats/Reducers.h); Get(stat) then reads them back as often as needed.
+    Genotype stats come straight from the population manager's GenotypeCensus (see
+    shared/stats/GenotypeCensus.h), which is kept up to date as organisms come and go.
+*/
+
+#ifndef POPULATION_STATS_H
+#define POPULATION_STATS_H
+
+#include <string>
+
+#include "Reducers.h"
+#include "../../shared/stats/GenotypeCensus.h"
+
+#include "tools/vector.h"
+
+enum class POP_STAT { ORGANISMS = 0, RESOURCES, MEAN_ENERGY, MAX_ENERGY, MEAN_ONES, GENOTYPES, GENOTYPE_ENTROPY,
+                      DOMINANT_COUNT, MEAN_PRESSURE, REPRO_LINKS, CONSUME_LINKS, NUM_STATS };
+
+class PopulationStats {
+  private:
+    emp::vector<double> values;
+
+  public:
+    PopulationStats() : values((int) POP_STAT::NUM_STATS, 0.0) { ; }
+
+    // Column names, in POP_STAT order.
+    static emp::vector<std::string> GetNames() {
+      return { "organisms", "resources", "mean_energy", "max_energy", "mean_ones", "genotypes", "genotype_entropy",
+               "dominant_count", "mean_pressure", "repro_links", "consume_links" };
+    }
+
+    // How many links of this type does body start? (Counted in place; GetLinksFromByType
+    // would build a vector per organism.)
+    template <typename BODY>
+    static int CountLinksFrom(const BODY &body, emp::BODY_LINK_TYPE type) {
+      int count = 0;
+      for (auto *link : body.GetFromLinks()) if (link->type == type) count++;
+      return count;
+    }
+
+    double Get(POP_STAT stat) const { return values[(int) stat]; }
+    const emp::vector<double> & GetValues() const { return values; }
+
+    // Take a new sample (between updates). With a pool, the pass is split across its threads.
+    template <typename POP_MANAGER>
+    void Sample(POP_MANAGER &popM, ThreadPool *pool = nullptr) {
+      using org_ptr_t = typename POP_MANAGER::value_type;
+      auto energy = [](org_ptr_t org) { return org->GetEnergy(); };
+      auto per_org = Fuse(reduce::Count(), reduce::Mean(energy), reduce::Max(energy),
+                          reduce::Mean([](org_ptr_t org) { return org->genome.CountOnes(); }),
+                          reduce::Mean([](org_ptr_t org) { return org->GetBody().GetPressure(); }),
+                          reduce::Sum([](org_ptr_t org) {
+                            return CountLinksFrom(org->GetBody(), emp::BODY_LINK_TYPE::REPRODUCTION); }),
+                          reduce::Sum([](org_ptr_t org) {
+                            return CountLinksFrom(org->GetBody(), emp::BODY_LINK_TYPE::CONSUME_RESOURCE); }));
+      const auto result = Reduce(per_org, popM.GetSize(), [&popM](int i) { return popM[i]; }, pool);
+      values.resize(0);
+      result.GetValues(values);
+      // Resources are counted, not walked; genotypes are already tallied.
+      values.insert(values.begin() + (int) POP_STAT::RESOURCES, popM.GetNumResources());
+      const GenotypeCensus<> &census = popM.GetCensus();
+      values.insert(values.begin() + (int) POP_STAT::GENOTYPES,
+                    { (double) census.GetRichness(), census.GetEntropy(), (double) census.GetDominantCount() });
+    }
+};
+
+#endif
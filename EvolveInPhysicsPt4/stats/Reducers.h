@@ -0,0 +1,134 @@
+/*
+  stats/Reducers.h
+    Reducers summarize a sequence of items (e.g. organisms) one item at a time, so that any
+    number of stats can be worked out in a single pass over the population.
+
+    A reducer has:
+      Add(item)            Take one more item into account.
+      Merge(other)         Take everything other has seen into account (for splitting a pass
+                           into chunks).
+      GetValues(values)    Append its result(s) to values.
+    reduce::Count(), reduce::Sum(fun), reduce::Mean(fun) and reduce::Max(fun) build the basic
+    ones (fun maps an item to a number). Fuse(r1, r2, ...) combines reducers into one that does
+    all their work per item; fused reducers can be fused again.
+
+    Reduce(prototype, count, get_item, pool) runs copies of prototype over fixed-size chunks
+    of items 0..count-1 (on pool's threads, if given) and merges them in chunk order, so
+    results do not depend on the number of threads.
+*/
+
+#ifndef REDUCERS_H
+#define REDUCERS_H
+
+#include <algorithm>
+#include <limits>
+
+#include "../../shared/parallel/ThreadPool.h"
+
+#include "tools/vector.h"
+
+namespace reduce {
+
+  class CountReducer {
+    private:
+      int count;
+
+    public:
+      CountReducer() : count(0) { ; }
+      template <typename T> void Add(const T &) { count++; }
+      void Merge(const CountReducer &other) { count += other.count; }
+      void GetValues(emp::vector<double> &values) const { values.push_back(count); }
+  };
+
+  template <typename FUN>
+  class SumReducer {
+    private:
+      FUN fun;
+      double sum;
+
+    public:
+      SumReducer(FUN _fun) : fun(_fun), sum(0.0) { ; }
+      template <typename T> void Add(const T &item) { sum += fun(item); }
+      void Merge(const SumReducer &other) { sum += other.sum; }
+      void GetValues(emp::vector<double> &values) const { values.push_back(sum); }
+  };
+
+  // Mean of nothing is 0.
+  template <typename FUN>
+  class MeanReducer {
+    private:
+      FUN fun;
+      double sum;
+      int count;
+
+    public:
+      MeanReducer(FUN _fun) : fun(_fun), sum(0.0), count(0) { ; }
+      template <typename T> void Add(const T &item) { sum += fun(item); count++; }
+      void Merge(const MeanReducer &other) { sum += other.sum; count += other.count; }
+      void GetValues(emp::vector<double> &values) const { values.push_back(count > 0 ? sum / count : 0.0); }
+  };
+
+  // Max of nothing is 0.
+  template <typename FUN>
+  class MaxReducer {
+    private:
+      FUN fun;
+      double max;
+      bool any;
+
+    public:
+      MaxReducer(FUN _fun) : fun(_fun), max(std::numeric_limits<double>::lowest()), any(false) { ; }
+      template <typename T> void Add(const T &item) { max = std::max(max, (double) fun(item)); any = true; }
+      void Merge(const MaxReducer &other) { max = std::max(max, other.max); any = any || other.any; }
+      void GetValues(emp::vector<double> &values) const { values.push_back(any ? max : 0.0); }
+  };
+
+  inline CountReducer Count() { return CountReducer(); }
+  template <typename FUN> SumReducer<FUN> Sum(FUN fun) { return SumReducer<FUN>(fun); }
+  template <typename FUN> MeanReducer<FUN> Mean(FUN fun) { return MeanReducer<FUN>(fun); }
+  template <typename FUN> MaxReducer<FUN> Max(FUN fun) { return MaxReducer<FUN>(fun); }
+
+}
+
+template <typename... REDUCERS> class FusedReducer;
+
+template <>
+class FusedReducer<> {
+  public:
+    template <typename T> void Add(const T &) { ; }
+    void Merge(const FusedReducer &) { ; }
+    void GetValues(emp::vector<double> &) const { ; }
+};
+
+template <typename FIRST, typename... REST>
+class FusedReducer<FIRST, REST...> {
+  private:
+    FIRST first;
+    FusedReducer<REST...> rest;
+
+  public:
+    FusedReducer(const FIRST &_first, const REST &... _rest) : first(_first), rest(_rest...) { ; }
+    template <typename T> void Add(const T &item) { first.Add(item); rest.Add(item); }
+    void Merge(const FusedReducer &other) { first.Merge(other.first); rest.Merge(other.rest); }
+    void GetValues(emp::vector<double> &values) const { first.GetValues(values); rest.GetValues(values); }
+};
+
+template <typename... REDUCERS>
+FusedReducer<REDUCERS...> Fuse(const REDUCERS &... reducers) { return FusedReducer<REDUCERS...>(reducers...); }
+
+// Run (a copy of) prototype over get_item(0), ..., get_item(count - 1).
+template <typename REDUCER, typename GET>
+REDUCER Reduce(const REDUCER &prototype, int count, GET get_item, ThreadPool *pool = nullptr, int chunk_size = 1024) {
+  const int num_chunks = std::max(1, (count + chunk_size - 1) / chunk_size);
+  emp::vector<REDUCER> partials(num_chunks, prototype);
+  auto run_chunk = [&partials, &get_item, count, chunk_size](int chunk) {
+    const int last = std::min(count, (chunk + 1) * chunk_size);
+    for (int i = chunk * chunk_size; i < last; i++) partials[chunk].Add(get_item(i));
+  };
+  if (pool != nullptr) pool->ParallelFor(num_chunks, run_chunk);
+  else for (int chunk = 0; chunk < num_chunks; chunk++) run_chunk(chunk);
+  for (int chunk = 1; chunk < num_chunks; chunk++) partials[0].Merge(partials[chunk]);
+  return partials[0];
+}
+
+#endif
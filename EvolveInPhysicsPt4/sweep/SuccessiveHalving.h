@@ -0,0 +1,219 @@
+/*
+  sweep/SuccessiveHalving.h
+    Defines SuccessiveHalving, which runs a parameter sweep and spends most of its updates on
+    the points that look most promising.
+
+    Every point is run with num_replicates seeds. All points get min_updates updates (rung
+    0); then, at every cut:
+      * points whose replicates all went extinct are dropped (extinct),
+      * points whose mean population grew by less than plateau_tolerance (as a fraction)
+        since the last cut, without having filled the world, are dropped (plateau),
+      * of the rest, the best 1/eta by mean population over the rung carry on (the others
+        are cut), and run until eta times as many updates have passed,
+    until the survivors reach max_updates (finished). Worlds carry on from where they were
+    at the cut; nothing is rerun.
+
+    Runs within a rung are spread over a WorkStealingPool. Each rung appends one row per
+    point that took part to the results table: point_id and rung (which together identify
+    the row), updates, status, the point's settings, then organisms, mean_organisms and
+    extinct (replicates gone extinct), then the trial's own stats, all averaged over
+    replicates.
+
+    TRIAL is one replicate of one point. It needs:
+      void RunTo(int update)          Advance (stopping early if extinct).
+      int GetSize() const             Organisms now.
+      double GetMeanSize() const      Mean organisms over the last RunTo.
+      bool IsSaturated() const        Is the population as big as the world allows?
+      emp::vector<double> GetStats()  One value per stat name.
+    Trials are built (by trial_factory, with the point id and seed) and advanced on worker
+    threads, so the factory must only read shared state.
+*/
+
+#ifndef SUCCESSIVE_HALVING_H
+#define SUCCESSIVE_HALVING_H
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../parallel/WorkStealingPool.h"
+#include "SweepSpec.h"
+
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+template <typename TRIAL>
+class SuccessiveHalving {
+  public:
+    using point_t = SweepSpec::point_t;
+    using trial_factory_t = std::function<TRIAL*(int, int)>;
+    enum class STATUS { RUNNING, EXTINCT, PLATEAU, CUT, FINISHED };
+
+  private:
+    struct Candidate {
+      int id;
+      emp::vector<std::unique_ptr<TRIAL> > trials;
+      double mean_size;         // Mean organisms over the last rung, averaged over replicates.
+      double prev_mean_size;
+      double size;
+      int extinct;
+      emp::vector<double> stats;
+      STATUS status;
+    };
+
+    emp::vector<std::string> point_names;
+    emp::vector<std::string> stat_names;
+    std::ostream &out;
+    std::string delimiter;
+    WorkStealingPool pool;
+
+    int min_updates;
+    int max_updates;
+    int eta;
+    double plateau_tolerance;
+
+    emp::vector<STATUS> final_status;
+    emp::vector<double> final_mean_size;
+    emp::vector<int> final_updates;
+
+    static const char * GetStatusName(STATUS status) {
+      switch (status) {
+        case STATUS::RUNNING: return "running";
+        case STATUS::EXTINCT: return "extinct";
+        case STATUS::PLATEAU: return "plateau";
+        case STATUS::CUT: return "cut";
+        case STATUS::FINISHED: return "finished";
+      }
+      return "unknown";
+    }
+
+    void Summarize(Candidate &candidate, int num_replicates) {
+      candidate.prev_mean_size = candidate.mean_size;
+      candidate.mean_size = candidate.size = 0.0;
+      candidate.extinct = 0;
+      candidate.stats.assign(stat_names.size(), 0.0);
+      for (auto &trial : candidate.trials) {
+        candidate.mean_size += trial->GetMeanSize() / num_replicates;
+        candidate.size += trial->GetSize() / (double) num_replicates;
+        if (trial->GetSize() == 0) candidate.extinct++;
+        const emp::vector<double> trial_stats = trial->GetStats();
+        emp_assert(trial_stats.size() == stat_names.size());
+        for (int s = 0; s < (int) trial_stats.size(); s++) candidate.stats[s] += trial_stats[s] / num_replicates;
+      }
+    }
+
+    bool IsSaturated(const Candidate &candidate) const {
+      for (auto &trial : candidate.trials) {
+        if (trial->GetSize() > 0 && !trial->IsSaturated()) return false;
+      }
+      return true;
+    }
+
+    void WriteRow(const Candidate &candidate, const point_t &point, int rung, int updates) {
+      out << candidate.id << delimiter << rung << delimiter << updates << delimiter << GetStatusName(candidate.status);
+      for (double value : point) out << delimiter << value;
+      out << delimiter << candidate.size << delimiter << candidate.mean_size << delimiter << candidate.extinct;
+      for (double value : candidate.stats) out << delimiter << value;
+      out << "\n";
+    }
+
+  public:
+    SuccessiveHalving(const emp::vector<std::string> &_point_names, const emp::vector<std::string> &_stat_names,
+                      std::ostream &_out, int num_threads, const std::string &_delimiter = ",")
+      : point_names(_point_names), stat_names(_stat_names), out(_out), delimiter(_delimiter), pool(num_threads),
+        min_updates(100), max_updates(1000), eta(3), plateau_tolerance(0.05)
+    { ; }
+
+    void SetSchedule(int _min_updates, int _max_updates, int _eta, double _plateau_tolerance) {
+      emp_assert(_min_updates > 0 && _eta > 1);
+      min_updates = std::min(_min_updates, _max_updates);
+      max_updates = _max_updates;
+      eta = _eta;
+      plateau_tolerance = _plateau_tolerance;
+    }
+
+    int GetNumThreads() const { return pool.GetNumThreads(); }
+    // After Run: how each point ended, its last mean population and how far it got.
+    STATUS GetStatus(int point_id) const { return final_status[point_id]; }
+    const char * GetStatusName(int point_id) const { return GetStatusName(final_status[point_id]); }
+    double GetMeanSize(int point_id) const { return final_mean_size[point_id]; }
+    int GetUpdates(int point_id) const { return final_updates[point_id]; }
+
+    void Run(const emp::vector<point_t> &points, int first_seed, int num_replicates,
+             const trial_factory_t &trial_factory) {
+      emp_assert(num_replicates > 0);
+      out << "point_id" << delimiter << "rung" << delimiter << "updates" << delimiter << "status";
+      for (const auto &name : point_names) out << delimiter << name;
+      out << delimiter << "organisms" << delimiter << "mean_organisms" << delimiter << "extinct";
+      for (const auto &name : stat_names) out << delimiter << name;
+      out << std::endl;
+
+      const int num_points = (int) points.size();
+      final_status.assign(num_points, STATUS::RUNNING);
+      final_mean_size.assign(num_points, 0.0);
+      final_updates.assign(num_points, 0);
+      emp::vector<Candidate> candidates(num_points);
+      emp::vector<int> alive;
+      for (int id = 0; id < num_points; id++) {
+        candidates[id].id = id;
+        candidates[id].trials.resize(num_replicates);
+        candidates[id].mean_size = 0.0;
+        candidates[id].status = STATUS::RUNNING;
+        alive.push_back(id);
+      }
+
+      int updates = min_updates;
+      for (int rung = 0; alive.size() > 0; rung++) {
+        // Advance every replicate of every live point to this rung's budget.
+        pool.Run((int) alive.size() * num_replicates, [&](int job) {
+          Candidate &candidate = candidates[alive[job / num_replicates]];
+          const int replicate = job % num_replicates;
+          auto &trial = candidate.trials[replicate];
+          if (!trial) trial.reset(trial_factory(candidate.id, first_seed + replicate));
+          trial->RunTo(updates);
+        });
+
+        // Drop the hopeless, then keep the best of the rest.
+        emp::vector<int> survivors;
+        for (int id : alive) {
+          Candidate &candidate = candidates[id];
+          Summarize(candidate, num_replicates);
+          if (candidate.extinct == num_replicates) candidate.status = STATUS::EXTINCT;
+          else if (rung > 0 && !IsSaturated(candidate)
+                   && candidate.mean_size < candidate.prev_mean_size * (1.0 + plateau_tolerance)) {
+            candidate.status = STATUS::PLATEAU;
+          }
+          else survivors.push_back(id);
+        }
+        if (updates >= max_updates) {
+          for (int id : survivors) candidates[id].status = STATUS::FINISHED;
+          survivors.resize(0);
+        } else {
+          std::stable_sort(survivors.begin(), survivors.end(), [&candidates](int a, int b) {
+            return candidates[a].mean_size > candidates[b].mean_size;
+          });
+          const int keep = std::max(1, ((int) survivors.size() + eta - 1) / eta);
+          for (int i = keep; i < (int) survivors.size(); i++) candidates[survivors[i]].status = STATUS::CUT;
+          if ((int) survivors.size() > keep) survivors.resize(keep);
+          std::sort(survivors.begin(), survivors.end());
+        }
+
+        for (int id : alive) {
+          Candidate &candidate = candidates[id];
+          WriteRow(candidate, points[id], rung, updates);
+          final_status[id] = candidate.status;
+          final_mean_size[id] = candidate.mean_size;
+          final_updates[id] = updates;
+          // Points that are out of the running free their worlds right away.
+          if (candidate.status != STATUS::RUNNING) candidate.trials.resize(0);
+        }
+        out.flush();
+        alive = survivors;
+        updates = (int) std::min<long long>((long long) updates * eta, max_updates);
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  sweep/SweepSpec.h
+    Defines SweepSpec, the list of settings a parameter sweep varies, read from a text file
+    with one setting per line ('#' starts a comment):
+      values NAME v1 v2 v3 ...          Exactly these values.
+      range NAME min max [steps]        Evenly spaced (grid: steps values, default 3;
+                                        random: uniform in [min, max]).
+      log_range NAME min max [steps]    Same, but evenly spaced in log space (min > 0).
+
+    GetGridPoints() gives every combination; GetRandomPoints(count, random) draws count
+    points, each setting independently ('values' settings pick one of their values). A point
+    is one value per setting, in the order the settings were listed.
+*/
+
+#ifndef SWEEP_SPEC_H
+#define SWEEP_SPEC_H
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "tools/Random.h"
+#include "tools/vector.h"
+#include "tools/assert.h"
+
+class SweepSpec {
+  public:
+    using point_t = emp::vector<double>;
+
+  private:
+    enum class KIND { VALUES, RANGE, LOG_RANGE };
+
+    struct Setting {
+      std::string name;
+      KIND kind;
+      emp::vector<double> values;   // VALUES only.
+      double min;
+      double max;
+      int steps;
+
+      emp::vector<double> GetGridValues() const {
+        if (kind == KIND::VALUES) return values;
+        emp::vector<double> grid;
+        for (int i = 0; i < steps; i++) {
+          const double frac = (steps > 1) ? i / (double) (steps - 1) : 0.0;
+          if (kind == KIND::RANGE) grid.push_back(min + frac * (max - min));
+          else grid.push_back(std::exp(std::log(min) + frac * (std::log(max) - std::log(min))));
+        }
+        return grid;
+      }
+
+      double Draw(emp::Random &random) const {
+        if (kind == KIND::VALUES) return values[random.GetUInt((uint32_t) values.size())];
+        if (kind == KIND::RANGE) return random.GetDouble(min, max);
+        return std::exp(random.GetDouble(std::log(min), std::log(max)));
+      }
+    };
+
+    emp::vector<Setting> settings;
+
+    static bool Fail(const std::string &filename, int line_num, const std::string &what) {
+      std::cerr << filename << ":" << line_num << ": " << what << std::endl;
+      return false;
+    }
+
+  public:
+    int GetNumSettings() const { return (int) settings.size(); }
+    const std::string & GetName(int id) const { return settings[id].name; }
+
+    // Load settings from filename (replacing any already loaded). Prints what was wrong and
+    // returns false if the file is missing or malformed.
+    bool Read(const std::string &filename) {
+      std::ifstream file(filename);
+      if (!file) {
+        std::cerr << "Could not open sweep file " << filename << std::endl;
+        return false;
+      }
+      settings.resize(0);
+      std::string line;
+      for (int line_num = 1; std::getline(file, line); line_num++) {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.resize(comment);
+        std::istringstream words(line);
+        std::string kind;
+        if (!(words >> kind)) continue;
+        Setting setting;
+        if (!(words >> setting.name)) return Fail(filename, line_num, "missing setting name");
+        setting.min = setting.max = 0.0;
+        setting.steps = 3;
+        if (kind == "values") {
+          setting.kind = KIND::VALUES;
+          double value;
+          while (words >> value) setting.values.push_back(value);
+          if (setting.values.size() == 0) return Fail(filename, line_num, "no values for " + setting.name);
+        } else if (kind == "range" || kind == "log_range") {
+          setting.kind = (kind == "range") ? KIND::RANGE : KIND::LOG_RANGE;
+          if (!(words >> setting.min >> setting.max)) return Fail(filename, line_num, "range needs min and max");
+          words >> setting.steps;
+          if (setting.steps < 1 || setting.max < setting.min) return Fail(filename, line_num, "bad range for " + setting.name);
+          if (setting.kind == KIND::LOG_RANGE && setting.min <= 0.0) return Fail(filename, line_num, "log_range needs min > 0");
+        } else {
+          return Fail(filename, line_num, "unknown kind '" + kind + "' (expected values, range or log_range)");
+        }
+        settings.push_back(setting);
+      }
+      return true;
+    }
+
+    emp::vector<point_t> GetGridPoints() const {
+      emp::vector<point_t> points(1);
+      for (const auto &setting : settings) {
+        emp::vector<point_t> extended;
+        for (const auto &point : points) {
+          for (double value : setting.GetGridValues()) {
+            extended.push_back(point);
+            extended.back().push_back(value);
+          }
+        }
+        points = extended;
+      }
+      return points;
+    }
+
+    emp::vector<point_t> GetRandomPoints(int count, emp::Random &random) const {
+      emp::vector<point_t> points(count);
+      for (auto &point : points) {
+        for (const auto &setting : settings) point.push_back(setting.Draw(random));
+      }
+      return points;
+    }
+};
+
+#endif
@@ -1,9 +1,12 @@
 #include <iostream>
 #include <string>
+#include <functional>
 
 #include "../Empirical/evo/World.h"       // Gives ability to generate simple world
 #include "../Empirical/tools/Random.h"
 
+#include "onemax/Selection/FitnessCache.h"
+
 using namespace emp::evo;
 
 ////////////////////////////////////////////////
@@ -94,11 +97,15 @@ int main() {
     world[i].Print(); std::cout << " ";
   } std::cout << std::endl;
 
+  // Evaluate each org once per generation; elite + tournament selection read the cache.
+  FitnessCache<Org> fit_cache;
+  std::function<double(Org *)> fit_fun = [](Org * org) { return org->Fitness(); };
   for (int gen = 0; gen < 100; gen++) {
-    // Elite selection -- get top 3 orgs, make 3 copies of each; add to next population
-    world.EliteSelect(3, 3);
+    fit_cache.Evaluate(world, fit_fun);
+    // Elite selection -- get top 3 orgs (partial selection, no full sort), make 3 copies of each; add to next population
+    fit_cache.EliteSelect(world, 3, 3);
     // This will run 36 tournaments. For each tournament, pick 5 randos to run tournament. (default: no discrete generations)
-    world.TournamentSelect(5, 36);
+    fit_cache.TournamentSelect(world, random, 5, 36);
     // if using PopEA, to trigger next generation: call world.Update
     world.Update();
     // Mutate!
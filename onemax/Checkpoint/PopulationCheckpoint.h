@@ -0,0 +1,49 @@
+/*
+  Checkpoint/PopulationCheckpoint.h
+    SavePopulation / LoadPopulation pack a OneMax world's update count and organisms (genome
+    plus cached fitness, and how many mutations since it was last evaluated in full) into a
+    checkpoint payload, and rebuild them into an empty world.
+
+    The random number generator and anything the world was built from (landscape, selection
+    mode, ...) are up to the driver: see onemax_evolve.cc.
+*/
+
+#ifndef POPULATIONCHECKPOINT_H
+#define POPULATIONCHECKPOINT_H
+
+#include "../../shared/checkpoint/CheckpointFile.h"
+
+#include "../Organisms/OneMaxOrganism.h"
+
+// Bump whenever the payload layout changes.
+constexpr uint32_t ONEMAX_CHECKPOINT_VERSION = 2;
+
+template <typename WORLD>
+void SavePopulation(ByteWriter &writer, WORLD &world) {
+  writer.Write((int) world.update);
+  writer.Write((int) world.GetSize());
+  for (int i = 0; i < (int) world.GetSize(); i++) {
+    const OneMaxOrganism &org = world[i];
+    writer.Write(org.genome).Write(org.fitness).Write(org.has_fitness).Write(org.mutations_since_refresh);
+  }
+}
+
+template <typename WORLD>
+bool LoadPopulation(ByteReader &reader, WORLD &world) {
+  emp_assert(world.GetSize() == 0);
+  const int update = reader.Read<int>();
+  const int pop_size = reader.Read<int>();
+  for (int i = 0; i < pop_size && reader.IsOK(); i++) {
+    OneMaxOrganism org(0);
+    reader.Read(org.genome);
+    org.fitness = reader.Read<double>();
+    org.has_fitness = reader.Read<bool>();
+    org.mutations_since_refresh = reader.Read<int>();
+    world.Insert(org);
+  }
+  if (!reader.IsOK()) return false;
+  world.update = update;
+  return true;
+}
+
+#endif
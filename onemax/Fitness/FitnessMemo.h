@@ -0,0 +1,168 @@
+/*
+  Fitness/FitnessMemo.h
+    Defines FitnessMemo, a bounded genotype -> fitness cache for bit-string organisms.
+
+    With low mutation rates, many organisms in a population share a genome. Wrap() turns a
+    fitness function into one that only calls through for genomes it has not seen lately:
+      world.SetDefaultFitnessFun(memo.Wrap(fit_fun));
+
+    * Genomes are keyed by a 64-bit hash of their 32-bit words (HashGenome). The genome is
+      stored alongside, so a hash collision is just a miss.
+    * The cache is split into shards (picked by hash), each with its own mutex and a fixed
+      number of entries. A full shard evicts with the CLOCK algorithm: hits set an entry's
+      reference bit and the clock hand evicts the first entry whose bit is clear.
+    * The fitness function itself runs outside of any lock, so the wrapped function is safe
+      to call from several threads at once as long as fit_fun is.
+    * Hit, miss and eviction counts are kept in atomics.
+
+    ORG needs an emp::BitVector member named genome (see OneMaxOrganism).
+*/
+
+#ifndef FITNESSMEMO_H
+#define FITNESSMEMO_H
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+#include "../../../Empirical/tools/BitVector.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+// 64-bit hash of a genome's contents (and length).
+inline uint64_t HashGenome(const emp::BitVector &genome) {
+  const int num_fields = (genome.GetSize() + 31) / 32;
+  uint64_t hash = 0x9E3779B97F4A7C15ULL ^ (uint64_t) genome.GetSize();
+  for (int i = 0; i < num_fields; i++) {
+    hash = (hash ^ genome.GetUInt(i)) * 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 31;
+  }
+  hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31);
+}
+
+template <typename ORG>
+class FitnessMemo {
+  public:
+    using fit_fun_t = std::function<double(ORG *)>;
+
+  private:
+    struct Entry {
+      uint64_t hash;
+      emp::BitVector genome;
+      double fitness;
+      bool referenced;
+    };
+
+    struct Shard {
+      std::mutex mutex;
+      emp::vector<Entry> entries;                 // Grows up to capacity, then recycled.
+      std::unordered_map<uint64_t, int> lookup;   // hash -> index into entries
+      int hand;                                   // CLOCK hand.
+
+      Shard() : hand(0) { ; }
+    };
+
+    const int shard_capacity;
+    emp::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> evictions;
+
+    Shard & GetShard(uint64_t hash) { return *shards[(hash >> 48) % shards.size()]; }
+
+    // Find a slot for a new entry in a (locked) shard, evicting if the shard is full.
+    int ClaimSlot(Shard &shard) {
+      if ((int) shard.entries.size() < shard_capacity) {
+        shard.entries.emplace_back();
+        return (int) shard.entries.size() - 1;
+      }
+      while (shard.entries[shard.hand].referenced) {
+        shard.entries[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard_capacity;
+      }
+      const int slot = shard.hand;
+      shard.hand = (shard.hand + 1) % shard_capacity;
+      shard.lookup.erase(shard.entries[slot].hash);
+      evictions.fetch_add(1, std::memory_order_relaxed);
+      return slot;
+    }
+
+  public:
+    // Holds up to capacity genomes, spread over num_shards shards.
+    FitnessMemo(int capacity = 65536, int num_shards = 16)
+      : shard_capacity(std::max(1, capacity / std::max(1, num_shards))), hits(0), misses(0), evictions(0)
+    {
+      emp_assert(capacity > 0 && num_shards > 0);
+      for (int i = 0; i < num_shards; i++) shards.emplace_back(new Shard());
+    }
+
+    uint64_t GetHits() const { return hits.load(); }
+    uint64_t GetMisses() const { return misses.load(); }
+    uint64_t GetEvictions() const { return evictions.load(); }
+    double GetHitRate() const {
+      const uint64_t lookups = GetHits() + GetMisses();
+      return (lookups > 0) ? (double) GetHits() / lookups : 0.0;
+    }
+
+    // Look up a genome; returns true (and sets fitness) on a hit.
+    bool Find(const emp::BitVector &genome, uint64_t hash, double &fitness) {
+      Shard &shard = GetShard(hash);
+      std::lock_guard<std::mutex> guard(shard.mutex);
+      auto it = shard.lookup.find(hash);
+      if (it == shard.lookup.end()) return false;
+      Entry &entry = shard.entries[it->second];
+      if (!(entry.genome == genome)) return false;
+      entry.referenced = true;
+      fitness = entry.fitness;
+      return true;
+    }
+
+    // Record the fitness of a genome (replacing any entry with the same hash).
+    void Store(const emp::BitVector &genome, uint64_t hash, double fitness) {
+      Shard &shard = GetShard(hash);
+      std::lock_guard<std::mutex> guard(shard.mutex);
+      auto it = shard.lookup.find(hash);
+      const int slot = (it != shard.lookup.end()) ? it->second : ClaimSlot(shard);
+      Entry &entry = shard.entries[slot];
+      entry.hash = hash;
+      entry.genome = genome;
+      entry.fitness = fitness;
+      entry.referenced = false;
+      shard.lookup[hash] = slot;
+    }
+
+    // Fitness of org, calling fit_fun only on a miss.
+    double Evaluate(ORG *org, const fit_fun_t &fit_fun) {
+      const uint64_t hash = HashGenome(org->genome);
+      double fitness;
+      if (Find(org->genome, hash, fitness)) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return fitness;
+      }
+      misses.fetch_add(1, std::memory_order_relaxed);
+      fitness = fit_fun(org);
+      Store(org->genome, hash, fitness);
+      return fitness;
+    }
+
+    // A drop-in replacement for fit_fun backed by this cache (which must outlive it).
+    fit_fun_t Wrap(const fit_fun_t &fit_fun) {
+      return [this, fit_fun](ORG *org) -> double { return Evaluate(org, fit_fun); };
+    }
+
+    void Clear() {
+      for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->mutex);
+        shard->entries.resize(0);
+        shard->lookup.clear();
+        shard->hand = 0;
+      }
+    }
+};
+
+#endif
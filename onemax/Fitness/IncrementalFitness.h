@@ -0,0 +1,94 @@
+/*
+  Fitness/IncrementalFitness.h
+    Defines IncrementalFitness, which builds World-style fitness and mutation functions that
+    keep each organism's fitness cached on the organism itself.
+
+    LANDSCAPE is any decomposable fitness function, i.e. a class with
+      double Evaluate(const emp::BitVector &genome) const
+      double GetDelta(const emp::BitVector &genome, const emp::vector<int> &flips) const
+    (OneMaxFitness, WeightedSiteFitness, NKLandscape).
+
+    * The fitness function only evaluates a genome from scratch if the organism has no cached
+      fitness yet (e.g. the initial population); otherwise it returns the cached value.
+    * Offspring are copies of their parent, so they inherit the parent's cached fitness. The
+      mutation function flips bits with a PointMutator and adds GetDelta() of the flipped
+      sites to the cached fitness: O(#flips) rather than O(genome length) per organism.
+    * Deltas are floating point, so rounding error would pile up along a lineage; every
+      refresh_interval mutations an organism's fitness is evaluated from scratch instead (and,
+      in debug builds, checked against the incremental value).
+    * From-scratch evaluations go through an evaluation function, landscape.Evaluate by
+      default; SetEvalFun swaps in another (e.g. GetEvalFun() wrapped by a FitnessMemo, see
+      FitnessMemo.h), which must give the same fitness for the same genome.
+
+    ORG needs a genome (emp::BitVector) plus 'fitness', 'has_fitness' and
+    'mutations_since_refresh' members (see OneMaxOrganism). The returned functions are safe to run on different organisms in
+    parallel as long as the landscape's Evaluate/GetDelta are.
+*/
+
+#ifndef INCREMENTALFITNESS_H
+#define INCREMENTALFITNESS_H
+
+#include <functional>
+#include <cmath>
+#include <algorithm>
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+#include "PointMutator.h"
+
+template <typename ORG, typename LANDSCAPE>
+class IncrementalFitness {
+  public:
+    using fit_fun_t = std::function<double(ORG *)>;
+    using mut_fun_t = std::function<bool(ORG *, emp::Random &)>;
+
+  private:
+    const LANDSCAPE &landscape;
+    PointMutator mutator;
+    int refresh_interval;
+    fit_fun_t eval_fun;   // From-scratch evaluation.
+
+  public:
+    IncrementalFitness(const LANDSCAPE &_landscape, double mut_rate, int _refresh_interval = 64)
+      : landscape(_landscape), mutator(mut_rate), refresh_interval(_refresh_interval), eval_fun(GetEvalFun())
+    { emp_assert(refresh_interval > 0); }
+
+    // Evaluate org from scratch with the landscape (no caching).
+    fit_fun_t GetEvalFun() const {
+      return [this](ORG *org) -> double { return landscape.Evaluate(org->genome); };
+    }
+    void SetEvalFun(const fit_fun_t &_eval_fun) { eval_fun = _eval_fun; }
+
+    // Evaluate org from scratch and cache the result.
+    double Refresh(ORG *org) const {
+      org->fitness = eval_fun(org);
+      org->has_fitness = true;
+      org->mutations_since_refresh = 0;
+      return org->fitness;
+    }
+
+    fit_fun_t GetFitFun() const {
+      return [this](ORG *org) -> double {
+        return org->has_fitness ? org->fitness : Refresh(org);
+      };
+    }
+
+    mut_fun_t GetMutFun() const {
+      return [this](ORG *org, emp::Random &random) -> bool {
+        static thread_local emp::vector<int> flips;     // Scratch space (per thread).
+        if (mutator.Mutate(org->genome, random, flips) == 0) return false;
+        if (!org->has_fitness) return true;
+        org->fitness += landscape.GetDelta(org->genome, flips);
+        if (++org->mutations_since_refresh >= refresh_interval) {
+          const double incremental = org->fitness;
+          Refresh(org);
+          emp_assert(std::abs(org->fitness - incremental) <= 1e-9 * std::max(1.0, std::abs(org->fitness)));
+        }
+        return true;
+      };
+    }
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*
+  Fitness/NKLandscape.h
+    Defines NKLandscape, a tunably rugged fitness landscape over bit strings.
+
+    Each of the N sites contributes a value that depends on its own state plus the states of
+    the next K sites (wrapping around). Contributions come from precomputed tables
+    (N tables of 2^(K+1) entries); fitness is their average.
+
+    * Evaluation copies the genome into 64-bit words a whole word at a time (with the first K
+      bits repeated at the end to handle wrap-around), then pulls each site's (K+1)-bit
+      window out with a couple of shifts: N table lookups per genome and no data-dependent
+      branches.
+    * GetDelta() re-evaluates only the windows touched by a set of point mutations.
+    * Scratch space is per thread, so one landscape can be shared by parallel evaluators.
+*/
+
+#ifndef NKLANDSCAPE_H
+#define NKLANDSCAPE_H
+
+#include <cstdint>
+#include <algorithm>
+
+#include "../../../Empirical/tools/BitVector.h"
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+class NKLandscape {
+  public:
+    using word_t = uint64_t;
+
+  private:
+    static constexpr int WORD_BITS = 64;
+
+    int N;
+    int K;
+    int window_size;                  // K + 1
+    word_t window_mask;
+    emp::vector<double> tables;       // tables[site * (1 << window_size) + window]
+
+    // Scratch space (per thread) for a packed genome: N bits, then K wrap-around bits.
+    emp::vector<word_t> & GetPacked() const {
+      static thread_local emp::vector<word_t> packed;
+      packed.assign((N + K + WORD_BITS - 1) / WORD_BITS + 1, 0);   // +1 so windows can always read a next word.
+      return packed;
+    }
+
+    // Once the first N bits are in 'packed', clear anything after them and repeat the first K.
+    void AddWrapAround(emp::vector<word_t> &packed) const {
+      const int last = N / WORD_BITS;
+      const int offset = N % WORD_BITS;
+      const word_t wrap = packed[0] & ((((word_t) 1) << K) - 1);    // K < N, so these are all genome bits.
+      packed[last] &= (((word_t) 1) << offset) - 1;
+      for (int i = last + 1; i < (int) packed.size(); i++) packed[i] = 0;
+      packed[last] |= wrap << offset;
+      if (offset + K > WORD_BITS) packed[last + 1] = wrap >> (WORD_BITS - offset);
+    }
+
+    // The (K+1)-bit window starting at site, read out of 'packed'.
+    word_t Window(const emp::vector<word_t> &packed, int site) const {
+      const int word = site / WORD_BITS;
+      const int offset = site % WORD_BITS;
+      // (hi << 1) << (63 - offset) avoids an undefined shift by 64 when offset == 0.
+      const word_t bits = (packed[word] >> offset) | ((packed[word + 1] << 1) << (WORD_BITS - 1 - offset));
+      return bits & window_mask;
+    }
+
+    double Contribution(int site, word_t window) const {
+      return tables[((size_t) site << window_size) + window];
+    }
+
+    double Score(emp::vector<word_t> &packed) const {
+      AddWrapAround(packed);
+      double total = 0.0;
+      for (int site = 0; site < N; site++) total += Contribution(site, Window(packed, site));
+      return total / N;
+    }
+
+    // Window at site, read straight from a genome (for the few windows GetDelta needs).
+    word_t Window(const emp::BitVector &genome, int site) const {
+      word_t window = 0;
+      for (int k = 0; k < window_size; k++) window |= (word_t) genome.Get((site + k) % N) << k;
+      return window;
+    }
+
+  public:
+    NKLandscape(int _N, int _K, emp::Random &random)
+      : N(_N), K(_K), window_size(_K + 1), window_mask((((word_t) 1) << (_K + 1)) - 1)
+    {
+      emp_assert(N > 0 && K >= 0 && K < N && K < 24);
+      tables.resize((size_t) N << window_size);
+      for (double &value : tables) value = random.GetDouble();
+    }
+
+    int GetN() const { return N; }
+    int GetK() const { return K; }
+
+    double GetContribution(int site, int window) const { return Contribution(site, (word_t) window); }
+
+    // Fitness of a genome (average site contribution).
+    double Evaluate(const emp::BitVector &genome) const {
+      emp_assert(genome.GetSize() == N);
+      emp::vector<word_t> &packed = GetPacked();
+      for (int word = 0; word < (N + 31) / 32; word++) {
+        packed[word / 2] |= (word_t) genome.GetUInt(word) << (32 * (word % 2));
+      }
+      return Score(packed);
+    }
+
+    // Fitness of a packed genome (e.g. a PopulationManager_BitMatrix row; bit i lives in
+    // row[i / 64] at position i % 64).
+    double Evaluate(const word_t *row, int genome_length) const {
+      emp_assert(genome_length == N);
+      emp::vector<word_t> &packed = GetPacked();
+      std::copy(row, row + (N + WORD_BITS - 1) / WORD_BITS, packed.begin());
+      return Score(packed);
+    }
+
+    // Change in fitness caused by flipping the sites in 'flips', given the genome *after*
+    // the flips. Only the windows containing a flipped site (at most (K+1) per flip) are
+    // looked at.
+    double GetDelta(const emp::BitVector &genome, const emp::vector<int> &flips) const {
+      emp_assert(genome.GetSize() == N);
+      static thread_local emp::vector<int> touched;     // Scratch space (per thread).
+      touched.resize(0);
+      for (int flip : flips) {
+        for (int k = 0; k < window_size; k++) touched.push_back((flip - k + N) % N);
+      }
+      std::sort(touched.begin(), touched.end());
+      touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+      double delta = 0.0;
+      for (int site : touched) {
+        const word_t new_window = Window(genome, site);
+        word_t old_window = new_window;
+        for (int flip : flips) {
+          const int k = (flip - site + N) % N;     // Where does this flip fall in the window?
+          if (k < window_size) old_window ^= (word_t) 1 << k;
+        }
+        delta += Contribution(site, new_window) - Contribution(site, old_window);
+      }
+      return delta / N;
+    }
+};
+
+#endif
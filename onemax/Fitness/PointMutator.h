@@ -0,0 +1,53 @@
+/*
+  Fitness/PointMutator.h
+    Defines PointMutator, per-site bit-flip mutation that reports which sites it flipped.
+
+    Rather than rolling for every site, the gap to the next flipped site is drawn from a
+    geometric distribution (as in PopulationManager_BitMatrix::MutatePop), so mutating a
+    genome costs O(mutations) instead of O(genome length). The flipped positions are handed
+    back so decomposable fitness functions can update a cached fitness (see
+    IncrementalFitness.h).
+*/
+
+#ifndef POINTMUTATOR_H
+#define POINTMUTATOR_H
+
+#include <cmath>
+#include <algorithm>
+
+#include "../../../Empirical/tools/BitVector.h"
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+class PointMutator {
+  private:
+    double mut_rate;
+    double log_q;     // log(1 - mut_rate)
+
+  public:
+    PointMutator(double _mut_rate)
+      : mut_rate(_mut_rate), log_q(std::log(1.0 - std::min(_mut_rate, 0.999999)))
+    { emp_assert(mut_rate >= 0.0 && mut_rate <= 1.0); }
+
+    double GetMutRate() const { return mut_rate; }
+
+    // Flip each site of genome with probability mut_rate. Flipped sites are written to
+    // flips in increasing order; returns how many there were.
+    int Mutate(emp::BitVector &genome, emp::Random &random, emp::vector<int> &flips) const {
+      flips.resize(0);
+      if (mut_rate <= 0.0) return 0;
+      const int genome_length = genome.GetSize();
+      int site = -1;
+      while (true) {
+        if (mut_rate >= 1.0) site += 1;
+        else site += 1 + (int) std::min((double) genome_length, std::log(1.0 - random.GetDouble()) / log_q);
+        if (site >= genome_length) break;
+        genome[site] = !genome[site];
+        flips.push_back(site);
+      }
+      return (int) flips.size();
+    }
+};
+
+#endif
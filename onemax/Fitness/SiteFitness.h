@@ -0,0 +1,58 @@
+/*
+  Fitness/SiteFitness.h
+    Decomposable fitness functions where every site contributes independently.
+
+    * OneMaxFitness: fitness is the number of ones.
+    * WeightedSiteFitness: a one at site i is worth weights[i].
+
+    Like NKLandscape, both provide Evaluate(genome) and GetDelta(genome, flips), where
+    GetDelta takes the genome *after* the sites in flips were toggled and costs O(#flips).
+*/
+
+#ifndef SITEFITNESS_H
+#define SITEFITNESS_H
+
+#include "../../../Empirical/tools/BitVector.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+class OneMaxFitness {
+  public:
+    double Evaluate(const emp::BitVector &genome) const {
+      return (double) genome.CountOnes();
+    }
+
+    double GetDelta(const emp::BitVector &genome, const emp::vector<int> &flips) const {
+      int delta = 0;
+      for (int site : flips) delta += genome.Get(site) ? 1 : -1;
+      return (double) delta;
+    }
+};
+
+class WeightedSiteFitness {
+  private:
+    emp::vector<double> weights;
+
+  public:
+    WeightedSiteFitness(const emp::vector<double> &_weights) : weights(_weights) { ; }
+
+    int GetSize() const { return (int) weights.size(); }
+    double GetWeight(int site) const { return weights[site]; }
+
+    double Evaluate(const emp::BitVector &genome) const {
+      emp_assert(genome.GetSize() == GetSize());
+      double total = 0.0;
+      for (int site = 0; site < GetSize(); site++) {
+        if (genome.Get(site)) total += weights[site];
+      }
+      return total;
+    }
+
+    double GetDelta(const emp::BitVector &genome, const emp::vector<int> &flips) const {
+      double delta = 0.0;
+      for (int site : flips) delta += genome.Get(site) ? weights[site] : -weights[site];
+      return delta;
+    }
+};
+
+#endif
@@ -15,8 +15,12 @@ class OneMaxOrganism {
   private:
   public:
     emp::BitVector genome;
+    double fitness;       // Cached fitness (see Fitness/IncrementalFitness.h).
+    bool has_fitness;
+    int mutations_since_refresh;    // Incremental updates to fitness since it was last evaluated in full.
 
-    OneMaxOrganism(int genome_length = 1): genome(genome_length, false)  {
+    OneMaxOrganism(int genome_length = 1)
+      : genome(genome_length, false), fitness(0.0), has_fitness(false), mutations_since_refresh(0)  {
       /* OneMaxOrganism constructor.
           Given a specified genome length, initialize one max organism.
           * Genome: a bitstring. Initialized to all 0's
@@ -0,0 +1,23 @@
+/*
+  Parallel/DeriveSeed.h
+    Derive independent random seeds for parallel streams (islands, worker threads, chunks)
+    from one run seed, so that results depend only on the run seed and the stream's ID.
+*/
+
+#ifndef DERIVESEED_H
+#define DERIVESEED_H
+
+#include <cstdint>
+
+// Mix (seed, stream_id) through the splitmix64 finalizer. Result is a positive int, as
+// emp::Random expects.
+inline int DeriveSeed(int seed, uint64_t stream_id) {
+  uint64_t x = ((uint64_t) (uint32_t) seed << 32) ^ stream_id;
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return (int) (x & 0x7FFFFFFF);
+}
+
+#endif
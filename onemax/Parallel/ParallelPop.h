@@ -0,0 +1,99 @@
+/*
+  Parallel/ParallelPop.h
+    Defines ParallelPop, thread-pool versions of World::MutatePop and whole-population
+    fitness evaluation.
+
+    The population is cut into fixed-size chunks (chunk_size organisms each) and the chunks
+    are spread over a ThreadPool. The chunking never depends on the number of threads, and
+    every call to MutatePop draws one seed from the master emp::Random; chunk c then mutates
+    with its own stream seeded by DeriveSeed(call_seed, c). So a run with a given master seed
+    gives identical results with 1 thread or 64.
+
+    Mutation and fitness functions must be safe to call from several threads at once (i.e.
+    only touch the organism and random number generator they are given).
+*/
+
+#ifndef PARALLELPOP_H
+#define PARALLELPOP_H
+
+#include <functional>
+#include <algorithm>
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+#include "../../shared/parallel/ThreadPool.h"
+#include "DeriveSeed.h"
+
+template <typename ORG>
+class ParallelPop {
+  public:
+    using fit_fun_t = std::function<double(ORG *)>;
+    using mut_fun_t = std::function<bool(ORG *, emp::Random &)>;
+
+  private:
+    ThreadPool &pool;
+    const int chunk_size;
+    emp::vector<int> chunk_counts;    // Per-chunk mutation counts.
+    emp::vector<int> chunk_bests;     // Per-chunk best organism IDs.
+
+    int NumChunks(int first, int last) const { return (last - first + chunk_size - 1) / chunk_size; }
+
+  public:
+    ParallelPop(ThreadPool &_pool, int _chunk_size = 64) : pool(_pool), chunk_size(_chunk_size) {
+      emp_assert(chunk_size > 0);
+    }
+
+    int GetChunkSize() const { return chunk_size; }
+
+    // Same as World::MutatePop: mutate organisms [first, last) (the first one is skipped by
+    // default). Returns the number of organisms mutated.
+    template <typename WORLD>
+    int MutatePop(WORLD &world, emp::Random &random, const mut_fun_t &mut_fun, int first = 1, int last = -1) {
+      if (last < 0 || last > world.GetSize()) last = world.GetSize();
+      if (first >= last) return 0;
+      const int call_seed = random.GetInt(1, 0x7FFFFFFF);
+      const int num_chunks = NumChunks(first, last);
+      chunk_counts.assign(num_chunks, 0);
+      pool.ParallelFor(num_chunks, [&](int chunk) {
+        emp::Random chunk_random(DeriveSeed(call_seed, (uint64_t) chunk));
+        const int chunk_first = first + chunk * chunk_size;
+        const int chunk_last = std::min(last, chunk_first + chunk_size);
+        int count = 0;
+        for (int i = chunk_first; i < chunk_last; i++) count += mut_fun(&world[i], chunk_random);
+        chunk_counts[chunk] = count;
+      });
+      int mut_count = 0;
+      for (int count : chunk_counts) mut_count += count;
+      return mut_count;
+    }
+
+    // Evaluate every organism in world once; fitnesses[i] is organism i's fitness. Returns the
+    // ID of the most fit organism (-1 if there are none); ties go to the lowest ID.
+    template <typename WORLD>
+    int EvaluatePop(WORLD &world, const fit_fun_t &fit_fun, emp::vector<double> &fitnesses) {
+      const int pop_size = world.GetSize();
+      const int num_chunks = NumChunks(0, pop_size);
+      fitnesses.resize(pop_size);
+      chunk_bests.assign(num_chunks, -1);
+      pool.ParallelFor(num_chunks, [&](int chunk) {
+        const int chunk_first = chunk * chunk_size;
+        const int chunk_last = std::min(pop_size, chunk_first + chunk_size);
+        int best_id = chunk_first;
+        for (int i = chunk_first; i < chunk_last; i++) {
+          fitnesses[i] = fit_fun(&world[i]);
+          if (fitnesses[i] > fitnesses[best_id]) best_id = i;
+        }
+        chunk_bests[chunk] = best_id;
+      });
+      // Chunks are compared in order, so ties still go to the lowest ID.
+      int best_id = -1;
+      for (int id : chunk_bests) {
+        if (best_id == -1 || fitnesses[id] > fitnesses[best_id]) best_id = id;
+      }
+      return best_id;
+    }
+};
+
+#endif
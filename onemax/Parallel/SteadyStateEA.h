@@ -0,0 +1,253 @@
+/*
+  Parallel/SteadyStateEA.h
+    Defines SteadyStateEA, an asynchronous steady-state EA. There are no generations: worker
+    threads each repeatedly
+      1. pick a parent by tournament,
+      2. copy and mutate it, then evaluate the offspring,
+      3. replace the loser of a second ("reverse") tournament with the offspring.
+
+    * Every slot's fitness is an atomic, so tournaments read fitnesses without any locking.
+    * Each slot has its own spinlock, held only while a genome is copied in or out of it.
+    * Births are counted with one atomic counter. Every report_interval births, the thread
+      that crosses the mark snapshots best/mean fitness and calls the report callback.
+    * A GenotypeCensus (see shared/stats/GenotypeCensus.h) follows every insertion and replacement
+      (skipped when the offspring's genome matches the loser's), so reports include genotype
+      richness, entropy and the dominant genotype's count without walking the population.
+      Workers don't touch the census: each tallies its net per-genome changes in its own
+      buffer, and the buffers are merged into the census at every report, at the end of Run
+      and whenever a buffer grows past the population size. ORG needs an emp::BitVector genome.
+      Mid-run reports' genotype numbers are approximate: other workers keep replacing
+      organisms while the buffers are merged, and a removal merged before the birth it undoes
+      is held back until that birth arrives. They are exact only once Run has returned.
+
+    Uses the same fitness/mutation function signatures as World, so the OneMax callbacks
+    plug straight in. Mutation and fitness functions must be safe to call from several
+    threads at once (i.e. only touch the organism and random number generator they are given).
+*/
+
+#ifndef STEADYSTATEEA_H
+#define STEADYSTATEEA_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <unordered_map>
+#include <algorithm>
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+#include "DeriveSeed.h"
+#include "../../shared/stats/GenotypeCensus.h"
+
+template <typename ORG>
+class SteadyStateEA {
+  public:
+    using fit_fun_t = std::function<double(ORG *)>;
+    using mut_fun_t = std::function<bool(ORG *, emp::Random &)>;
+
+    struct Report {
+      uint64_t births;
+      double best_fitness;
+      double mean_fitness;
+      double births_per_sec;
+      int genotypes;            // Approximate (see top of file); for exact numbers, read
+      double genotype_entropy;  // GetCensus() after Run returns.
+      int dominant_count;
+    };
+    using report_fun_t = std::function<void(const Report &)>;
+
+  private:
+    struct Slot {
+      std::atomic_flag lock;
+      std::atomic<double> fitness;
+      ORG org;
+
+      Slot(const ORG &_org) : fitness(0.0), org(_org) { lock.clear(); }
+      void Lock() { while (lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield(); }
+      void Unlock() { lock.clear(std::memory_order_release); }
+    };
+
+    // One worker's census changes since they were last merged (net +/- count per genome).
+    using census_deltas_t = std::unordered_map<emp::BitVector, int, GenomeHash>;
+    struct CensusBuffer {
+      std::mutex mutex;           // Taken by its worker once per birth, and when merging.
+      census_deltas_t deltas;
+    };
+
+    emp::vector<std::unique_ptr<Slot>> slots;
+    fit_fun_t fit_fun;
+    mut_fun_t mut_fun;
+    int t_size;
+
+    std::atomic<uint64_t> births;
+    uint64_t run_start_births;
+    uint64_t max_births;
+    int run_count;
+    uint64_t report_interval;
+    report_fun_t report_fun;
+    std::mutex report_mutex;      // Only taken once per report_interval births.
+    std::chrono::steady_clock::time_point start_time;
+    GenotypeCensus<> census;
+    emp::vector<std::unique_ptr<CensusBuffer>> census_buffers;   // One per worker.
+    census_deltas_t census_owed;  // Removals merged before the additions they undo (see MergeCensus).
+    std::mutex census_mutex;      // Guards census and census_owed; never taken with a buffer's lock held.
+
+    int PopSize() const { return (int) slots.size(); }
+
+    // Tournament on the atomically-read fitnesses. Finds the best if want_best, else the worst.
+    int RunTournament(emp::Random &random, bool want_best) const {
+      int win_id = random.GetInt(PopSize());
+      double win_fitness = slots[win_id]->fitness.load(std::memory_order_relaxed);
+      for (int i = 1; i < t_size; i++) {
+        const int id = random.GetInt(PopSize());
+        const double fitness = slots[id]->fitness.load(std::memory_order_relaxed);
+        if (want_best ? (fitness > win_fitness) : (fitness < win_fitness)) {
+          win_id = id;
+          win_fitness = fitness;
+        }
+      }
+      return win_id;
+    }
+
+    static void Tally(census_deltas_t &deltas, const emp::BitVector &genome, int delta) {
+      auto it = deltas.find(genome);
+      if (it == deltas.end()) it = deltas.emplace(genome, 0).first;
+      if ((it->second += delta) == 0) deltas.erase(it);
+    }
+
+    // Take buffer's changes and apply them to the census. One worker may replace an organism
+    // before the worker that placed it has handed over its own changes, so a removal can
+    // arrive before its addition; it is owed until then (counts never go below zero, and once
+    // every buffer has been merged nothing is owed).
+    void MergeCensus(CensusBuffer &buffer) {
+      census_deltas_t deltas;
+      {
+        std::lock_guard<std::mutex> guard(buffer.mutex);
+        deltas.swap(buffer.deltas);
+      }
+      std::lock_guard<std::mutex> census_guard(census_mutex);
+      for (auto &owed : census_owed) Tally(deltas, owed.first, owed.second);
+      census_owed.clear();
+      for (auto &entry : deltas) {
+        int delta = entry.second;
+        for (; delta > 0; delta--) census.Add(entry.first);
+        const int removals = std::min(-delta, census.GetCount(entry.first));
+        for (int i = 0; i < removals; i++) census.Remove(entry.first);
+        if (delta + removals < 0) census_owed.emplace(entry.first, delta + removals);
+      }
+    }
+
+    void MakeReport(uint64_t birth_count) {
+      std::lock_guard<std::mutex> guard(report_mutex);
+      Report report;
+      report.births = birth_count;
+      report.best_fitness = slots[0]->fitness.load(std::memory_order_relaxed);
+      double total_fitness = 0.0;
+      for (auto &slot : slots) {
+        const double fitness = slot->fitness.load(std::memory_order_relaxed);
+        if (fitness > report.best_fitness) report.best_fitness = fitness;
+        total_fitness += fitness;
+      }
+      report.mean_fitness = total_fitness / PopSize();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+      report.births_per_sec = (elapsed.count() > 0.0) ? (birth_count - run_start_births) / elapsed.count() : 0.0;
+      for (auto &buffer : census_buffers) MergeCensus(*buffer);
+      {
+        std::lock_guard<std::mutex> census_guard(census_mutex);
+        report.genotypes = census.GetRichness();
+        report.genotype_entropy = census.GetEntropy();
+        report.dominant_count = census.GetDominantCount();
+      }
+      if (report_fun) report_fun(report);
+    }
+
+    void RunWorker(int seed, uint64_t stream_id, CensusBuffer &census_buffer) {
+      emp::Random random(DeriveSeed(seed, stream_id));
+      bool buffer_full = false;
+      while (true) {
+        const uint64_t birth_id = births.fetch_add(1, std::memory_order_relaxed);
+        if (birth_id >= max_births) break;
+        // Copy out the parent.
+        Slot &parent_slot = *slots[RunTournament(random, true)];
+        parent_slot.Lock();
+        ORG offspring(parent_slot.org);
+        double fitness = parent_slot.fitness.load(std::memory_order_relaxed);
+        parent_slot.Unlock();
+        // Mutate and (re)evaluate outside of any lock.
+        if (mut_fun(&offspring, random)) fitness = fit_fun(&offspring);
+        // Replace a loser in place.
+        Slot &loser_slot = *slots[RunTournament(random, false)];
+        loser_slot.Lock();
+        if (loser_slot.org.genome != offspring.genome) {
+          std::lock_guard<std::mutex> buffer_guard(census_buffer.mutex);
+          Tally(census_buffer.deltas, loser_slot.org.genome, -1);
+          Tally(census_buffer.deltas, offspring.genome, 1);
+          buffer_full = ((int) census_buffer.deltas.size() > PopSize());
+        }
+        loser_slot.org = offspring;
+        loser_slot.fitness.store(fitness, std::memory_order_relaxed);
+        loser_slot.Unlock();
+        if (buffer_full) {
+          MergeCensus(census_buffer);
+          buffer_full = false;
+        }
+        if (report_interval > 0 && (birth_id + 1) % report_interval == 0) MakeReport(birth_id + 1);
+      }
+    }
+
+  public:
+    SteadyStateEA(const fit_fun_t &_fit_fun, const mut_fun_t &_mut_fun, int _t_size = 4)
+      : fit_fun(_fit_fun), mut_fun(_mut_fun), t_size(_t_size), births(0),
+        run_start_births(0), max_births(0), run_count(0), report_interval(0)
+    { emp_assert(t_size > 0); }
+
+    int GetSize() const { return PopSize(); }
+    uint64_t GetBirths() const { return births.load() < max_births ? births.load() : max_births; }
+    const ORG & GetOrg(int id) const { return slots[id]->org; }   // Only safe while not running.
+    double GetFitness(int id) const { return slots[id]->fitness.load(); }
+    const GenotypeCensus<> & GetCensus() const { return census; }   // Only safe while not running.
+
+    // Add an organism to the population (before Run).
+    void Insert(const ORG &org) {
+      slots.emplace_back(new Slot(org));
+      census.Add(org.genome);
+      slots.back()->fitness.store(fit_fun(&slots.back()->org));
+    }
+
+    // Call report_fun every interval births.
+    void SetReport(uint64_t interval, const report_fun_t &_report_fun) {
+      report_interval = interval;
+      report_fun = _report_fun;
+    }
+
+    // Run until total_births more offspring have been placed, using num_threads workers.
+    // Returns births per second.
+    double Run(uint64_t total_births, int num_threads, int seed) {
+      emp_assert(PopSize() >= t_size && num_threads > 0);
+      run_start_births = GetBirths();
+      births.store(run_start_births);
+      max_births = run_start_births + total_births;
+      start_time = std::chrono::steady_clock::now();
+      census_buffers.resize(0);
+      for (int i = 0; i < num_threads; i++) census_buffers.emplace_back(new CensusBuffer());
+      emp::vector<std::thread> workers;
+      for (int i = 0; i < num_threads; i++) {
+        // Every worker of every Run call gets its own stream.
+        const uint64_t stream_id = ((uint64_t) run_count << 32) | (uint64_t) i;
+        workers.emplace_back(&SteadyStateEA::RunWorker, this, seed, stream_id, std::ref(*census_buffers[i]));
+      }
+      run_count++;
+      for (auto &worker : workers) worker.join();
+      for (auto &buffer : census_buffers) MergeCensus(*buffer);
+      emp_assert(census_owed.size() == 0);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+      return (elapsed.count() > 0.0) ? total_births / elapsed.count() : 0.0;
+    }
+};
+
+#endif
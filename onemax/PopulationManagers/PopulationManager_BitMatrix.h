@@ -0,0 +1,358 @@
+/*
+  PopulationManagers/PopulationManager_BitMatrix.h
+    Defines a population manager that stores every genome of a bit-string population
+    in one contiguous, row-major bit matrix instead of one heap BitVector per organism.
+
+    * Each row is one genome, padded out to a multiple of 64 bytes so that every row starts
+      on a cache line.
+    * Generations are double-buffered: selection records parent indices for the next
+      generation, and Update() builds the next generation by memcpy'ing parent rows.
+    * Mutation and evaluation stream straight over the matrix.
+    * A GenotypeCensus (see shared/stats/GenotypeCensus.h) keyed on whole rows follows every
+      path that changes a row: AddOrg, Update (the new generation replaces the old one),
+      MutatePop (only the rows it flips bits in) and write-back of views. GetCensus() is exact
+      between calls.
+
+    ORG must have a public emp::BitVector 'genome' and be constructible from a genome
+    length (e.g. OneMaxOrganism). Organisms handed to AddOrg/AddOrgBirth are copied into the
+    matrix and then deleted -- the matrix is the population.
+
+    World::operator[] still works: popM[i] materializes row i into a cached view organism.
+    Changes made through a view are written back to the matrix before it is next read.
+*/
+
+#ifndef POPULATION_MANAGER_BIT_MATRIX_H
+#define POPULATION_MANAGER_BIT_MATRIX_H
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "../../../Empirical/evo/PopulationManager.h"
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+#include "../../shared/stats/GenotypeCensus.h"
+
+namespace emp {
+namespace evo {
+
+template <typename ORG>
+class PopulationManager_BitMatrix {
+  public:
+    using word_t = uint64_t;
+    using row_t = emp::vector<word_t>;
+
+    // Hash of a row's words (equal rows, equal hashes).
+    struct RowHash {
+      uint64_t operator()(const row_t &row) const {
+        uint64_t hash = 14695981039346656037ull ^ (uint64_t) row.size();
+        for (word_t word : row) {
+          hash ^= word;
+          hash *= 1099511628211ull;
+        }
+        return hash;
+      }
+    };
+
+  protected:
+    using Org_t = ORG;
+
+    static constexpr int WORD_BITS = 64;
+    static constexpr int ROW_ALIGN_WORDS = 8;   // 8 words * 8 bytes = 64 byte rows.
+
+    // One generation's worth of rows. Storage is over-allocated so that the first row can be
+    // shifted onto a 64 byte boundary.
+    struct RowBuffer {
+      emp::vector<word_t> storage;
+      word_t *rows;
+      int capacity;   // In rows.
+
+      RowBuffer() : rows(nullptr), capacity(0) { ; }
+
+      void Reserve(int num_rows, int row_words) {
+        if (num_rows <= capacity) return;
+        emp::vector<word_t> new_storage((size_t) num_rows * row_words + ROW_ALIGN_WORDS, 0);
+        word_t *new_rows = Align(new_storage.data());
+        if (rows != nullptr) std::memcpy(new_rows, rows, (size_t) capacity * row_words * sizeof(word_t));
+        storage.swap(new_storage);
+        rows = new_rows;
+        capacity = num_rows;
+      }
+
+      static word_t * Align(word_t *ptr) {
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+        const uintptr_t aligned = (addr + (ROW_ALIGN_WORDS * sizeof(word_t) - 1)) & ~(uintptr_t)(ROW_ALIGN_WORDS * sizeof(word_t) - 1);
+        return reinterpret_cast<word_t*>(aligned);
+      }
+    };
+
+    Random *random_ptr;   // This comes from world. PopManager does not own random_ptr.
+
+    int genome_length;    // Bits per genome (-1 until the first organism arrives).
+    int row_words;        // Words per row (padded to a multiple of ROW_ALIGN_WORDS).
+    word_t tail_mask;     // Mask of the valid bits in the last genome word of a row.
+
+    RowBuffer buffers[2];
+    int cur_buffer;       // Which buffer holds the current generation?
+    int pop_size;
+    int next_size;
+    // Where does each row of the next generation come from? Index into the current
+    // generation, or -1 if the row was written directly (e.g. by AddOrgBirth).
+    emp::vector<int> next_parents;
+
+    // Materialized organisms handed out through operator[].
+    emp::vector<Org_t*> views;
+    emp::vector<int> checked_out;   // Rows whose views may have been modified.
+    emp::vector<bool> is_checked_out;
+
+    GenotypeCensus<row_t, RowHash> census;   // One entry per distinct row in the current generation.
+    row_t census_key;                        // Scratch key (so census updates don't allocate).
+
+    word_t * CurRows() { return buffers[cur_buffer].rows; }
+    const word_t * CurRows() const { return buffers[cur_buffer].rows; }
+    word_t * NextRows() { return buffers[1 - cur_buffer].rows; }
+
+    void SetGenomeLength(int length) {
+      emp_assert(length > 0);
+      genome_length = length;
+      const int genome_words = (length + WORD_BITS - 1) / WORD_BITS;
+      row_words = ((genome_words + ROW_ALIGN_WORDS - 1) / ROW_ALIGN_WORDS) * ROW_ALIGN_WORDS;
+      const int tail_bits = length % WORD_BITS;
+      tail_mask = (tail_bits == 0) ? ~(word_t) 0 : (((word_t) 1 << tail_bits) - 1);
+    }
+
+    void StoreGenome(word_t *row, const emp::BitVector &genome) const {
+      emp_assert(genome.GetSize() == genome_length);
+      std::memset(row, 0, row_words * sizeof(word_t));
+      for (int i = 0; i < genome_length; i++) {
+        if (genome.Get(i)) row[i / WORD_BITS] |= (word_t) 1 << (i % WORD_BITS);
+      }
+    }
+
+    void LoadGenome(const word_t *row, emp::BitVector &genome) const {
+      emp_assert(genome.GetSize() == genome_length);
+      for (int i = 0; i < genome_length; i++) {
+        genome.Set(i, (row[i / WORD_BITS] >> (i % WORD_BITS)) & 1);
+      }
+    }
+
+    const row_t & CensusKey(const word_t *row) {
+      census_key.assign(row, row + row_words);
+      return census_key;
+    }
+    void CensusAdd(const word_t *row) { census.Add(CensusKey(row)); }
+    void CensusRemove(const word_t *row) { census.Remove(CensusKey(row)); }
+
+    // Write any views that were handed out back into the current generation.
+    void FlushViews() {
+      for (int id : checked_out) {
+        CensusRemove(GetRow(id));
+        StoreGenome(GetRow(id), views[id]->genome);
+        CensusAdd(GetRow(id));
+        is_checked_out[id] = false;
+      }
+      checked_out.resize(0);
+    }
+
+    int ReserveNextRow(int parent_id) {
+      const int pos = next_size++;
+      buffers[1 - cur_buffer].Reserve(next_size, row_words);
+      if ((int) next_parents.size() < next_size) next_parents.resize(next_size);
+      next_parents[pos] = parent_id;
+      return pos;
+    }
+
+  public:
+    PopulationManager_BitMatrix()
+      : random_ptr(nullptr),
+        genome_length(-1),
+        row_words(0),
+        tail_mask(0),
+        cur_buffer(0),
+        pop_size(0),
+        next_size(0)
+    { ; }
+
+    ~PopulationManager_BitMatrix() { ClearViews(); }
+
+    // Allow this and derived classes to be identified as a population manager:
+    static constexpr bool emp_is_population_manager = true;
+    static constexpr bool emp_has_separate_generations = true;
+    using value_type = Org_t*;
+
+    // Setup iterator for the population.
+    friend class PopulationIterator<PopulationManager_BitMatrix<Org_t> >;
+    using iterator = PopulationIterator<PopulationManager_BitMatrix<Org_t> >;
+
+    // Materialize row i as an organism.
+    Org_t* & operator[](int i) {
+      emp_assert(i >= 0 && i < pop_size);
+      if ((int) views.size() < pop_size) {
+        views.resize(pop_size, nullptr);
+        is_checked_out.resize(pop_size, false);
+      }
+      if (views[i] == nullptr) views[i] = new Org_t(genome_length);
+      if (!is_checked_out[i]) {
+        LoadGenome(GetRow(i), views[i]->genome);
+        is_checked_out[i] = true;
+        checked_out.push_back(i);
+      }
+      return views[i];
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, pop_size); }
+
+    uint32_t size() const { return (uint32_t) pop_size; }
+    int GetSize() const { return pop_size; }
+    int GetNextSize() const { return next_size; }
+    int GetGenomeLength() const { return genome_length; }
+    int GetRowWords() const { return row_words; }
+    word_t GetTailMask() const { return tail_mask; }
+    // Genotypes of the current generation (views handed out through operator[] count once
+    // they are written back, i.e. at the next call that reads the matrix).
+    const GenotypeCensus<row_t, RowHash> & GetCensus() const { return census; }
+    word_t * GetRow(int i) { emp_assert(i >= 0 && i < pop_size); return CurRows() + (size_t) i * row_words; }
+    const word_t * GetRow(int i) const { emp_assert(i >= 0 && i < pop_size); return CurRows() + (size_t) i * row_words; }
+
+    void Setup(Random *r) { random_ptr = r; }
+
+    // Optional: fix the genome length up front (otherwise the first organism added decides).
+    void ConfigPop(int genome_length) {
+      emp_assert(pop_size == 0 && next_size == 0);
+      SetGenomeLength(genome_length);
+    }
+
+    void ClearViews() {
+      for (auto *view : views) if (view != nullptr) delete view;
+      views.resize(0);
+      is_checked_out.resize(0);
+      checked_out.resize(0);
+    }
+
+    void Clear() {
+      ClearViews();
+      pop_size = 0;
+      next_size = 0;
+      census.Clear();
+    }
+
+    // Add new organism to the current generation. Return position in population.
+    int AddOrg(Org_t *new_org) {
+      if (genome_length < 0) SetGenomeLength(new_org->genome.GetSize());
+      const int pos = pop_size++;
+      buffers[cur_buffer].Reserve(pop_size, row_words);
+      StoreGenome(GetRow(pos), new_org->genome);
+      CensusAdd(GetRow(pos));
+      delete new_org;
+      return pos;
+    }
+
+    // Add new organism to the next generation. Return position in next generation.
+    int AddOrgBirth(Org_t *new_org, int parent_pos) {
+      if (genome_length < 0) SetGenomeLength(new_org->genome.GetSize());
+      const int pos = ReserveNextRow(-1);
+      StoreGenome(NextRows() + (size_t) pos * row_words, new_org->genome);
+      delete new_org;
+      return pos;
+    }
+
+    // Fast path for selection: schedule copy_count copies of parent_id into the next generation.
+    // No genome is copied until Update().
+    void AddParent(int parent_id, int copy_count = 1) {
+      emp_assert(parent_id >= 0 && parent_id < pop_size);
+      for (int i = 0; i < copy_count; i++) ReserveNextRow(parent_id);
+    }
+
+    // Run count tournaments of size t_size over precomputed fitnesses (one per row).
+    void TournamentSelect(const emp::vector<double> &fitnesses, int t_size, int count) {
+      emp_assert((int) fitnesses.size() >= pop_size && t_size > 0 && pop_size > 0);
+      for (int t = 0; t < count; t++) {
+        int best_id = random_ptr->GetInt(pop_size);
+        for (int i = 1; i < t_size; i++) {
+          const int id = random_ptr->GetInt(pop_size);
+          if (fitnesses[id] > fitnesses[best_id]) best_id = id;
+        }
+        AddParent(best_id);
+      }
+    }
+
+    // Number of ones in row i.
+    int CountOnes(int i) const {
+      const word_t *row = GetRow(i);
+      int ones = 0;
+      for (int w = 0; w < row_words; w++) ones += __builtin_popcountll(row[w]);
+      return ones;
+    }
+
+    // Stream fit_fun over every row: fit_fun(const word_t *row, int genome_length) -> double.
+    template <typename FIT_FUN>
+    void EvaluatePop(FIT_FUN fit_fun, emp::vector<double> &fitnesses) {
+      FlushViews();
+      fitnesses.resize(pop_size);
+      for (int i = 0; i < pop_size; i++) fitnesses[i] = fit_fun(GetRow(i), genome_length);
+    }
+
+    // OneMax fitness of every row.
+    void EvaluateOnes(emp::vector<double> &fitnesses) {
+      FlushViews();
+      fitnesses.resize(pop_size);
+      for (int i = 0; i < pop_size; i++) fitnesses[i] = (double) CountOnes(i);
+    }
+
+    // Flip each bit in rows [first_mut, last_mut) with probability mut_rate. As with
+    // World::MutatePop, the first row is skipped by default.
+    // Rather than rolling for every site, draw the gap to the next mutation from a geometric
+    // distribution; this treats the rows as one long bit string and costs O(mutations).
+    // Returns the number of bits flipped.
+    int MutatePop(double mut_rate, int first_mut = 1, int last_mut = -1) {
+      FlushViews();
+      if (last_mut < 0 || last_mut > pop_size) last_mut = pop_size;
+      if (mut_rate <= 0.0 || first_mut >= last_mut) return 0;
+      const int64_t total_bits = (int64_t) (last_mut - first_mut) * genome_length;
+      const double log_q = std::log(1.0 - std::min(mut_rate, 0.999999));
+      int flips = 0;
+      int64_t site = -1;
+      int cur_row = -1;   // Row being mutated (out of the census until we move past it).
+      while (true) {
+        if (mut_rate >= 1.0) site += 1;
+        else site += 1 + (int64_t) (std::log(1.0 - random_ptr->GetDouble()) / log_q);
+        if (site >= total_bits) break;
+        const int row_id = first_mut + (int) (site / genome_length);
+        const int bit = (int) (site % genome_length);
+        if (row_id != cur_row) {
+          if (cur_row >= 0) CensusAdd(GetRow(cur_row));
+          CensusRemove(GetRow(row_id));
+          cur_row = row_id;
+        }
+        GetRow(row_id)[bit / WORD_BITS] ^= (word_t) 1 << (bit % WORD_BITS);
+        flips++;
+      }
+      if (cur_row >= 0) CensusAdd(GetRow(cur_row));
+      return flips;
+    }
+
+    // Move to the next generation: copy scheduled parent rows into the next buffer, then swap.
+    void Update() {
+      FlushViews();
+      word_t *next_rows = NextRows();
+      const size_t row_bytes = row_words * sizeof(word_t);
+      for (int i = 0; i < next_size; i++) {
+        if (next_parents[i] < 0) continue;  // Already written.
+        std::memcpy(next_rows + (size_t) i * row_words, GetRow(next_parents[i]), row_bytes);
+      }
+      cur_buffer = 1 - cur_buffer;
+      pop_size = next_size;
+      next_size = 0;
+      census.Clear();
+      for (int i = 0; i < pop_size; i++) CensusAdd(GetRow(i));
+    }
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+  Selection/AliasTable.h
+    Defines AliasTable, Walker's alias method for sampling from a discrete distribution.
+    Build() takes O(N) (Vose's variant); every Sample() after that is O(1): one uniform
+    draw picks a column, a second decides between the column and its alias.
+*/
+
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+class AliasTable {
+  private:
+    emp::vector<double> prob;   // Probability of keeping column i (vs. taking its alias).
+    emp::vector<int> alias;
+    emp::vector<int> small;     // Scratch space, kept around to avoid reallocating every build.
+    emp::vector<int> large;
+
+  public:
+    AliasTable() { ; }
+
+    int GetSize() const { return (int) prob.size(); }
+
+    // Build the table from non-negative weights. If every weight is zero, sampling is uniform.
+    void Build(const emp::vector<double> &weights) {
+      const int N = (int) weights.size();
+      emp_assert(N > 0);
+      prob.resize(N);
+      alias.resize(N);
+      small.resize(0);
+      large.resize(0);
+      double total = 0.0;
+      for (double w : weights) { emp_assert(w >= 0.0); total += w; }
+      if (total <= 0.0) {
+        for (int i = 0; i < N; i++) { prob[i] = 1.0; alias[i] = i; }
+        return;
+      }
+      // Scale so that the average column holds exactly 1.0.
+      const double scale = N / total;
+      for (int i = 0; i < N; i++) {
+        prob[i] = weights[i] * scale;
+        alias[i] = i;
+        if (prob[i] < 1.0) small.push_back(i);
+        else large.push_back(i);
+      }
+      // Top off each under-full column with mass from an over-full one.
+      while (small.size() && large.size()) {
+        const int s = small.back(); small.pop_back();
+        const int l = large.back();
+        alias[s] = l;
+        prob[l] -= 1.0 - prob[s];
+        if (prob[l] < 1.0) { large.pop_back(); small.push_back(l); }
+      }
+      // Anything left over is full up to rounding error.
+      for (int i : small) prob[i] = 1.0;
+      for (int i : large) prob[i] = 1.0;
+    }
+
+    int Sample(emp::Random &random) const {
+      emp_assert(GetSize() > 0);
+      const int col = random.GetInt(GetSize());
+      return (random.GetDouble() < prob[col]) ? col : alias[col];
+    }
+};
+
+#endif
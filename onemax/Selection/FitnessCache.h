@@ -0,0 +1,164 @@
+/*
+  Selection/FitnessCache.h
+    Defines FitnessCache, a per-generation fitness array for World-based EAs.
+
+    World::TournamentSelect calls the fitness function for every tournament entry, so each
+    organism gets evaluated about t_size times per generation. Instead, Evaluate() runs the
+    fitness function exactly once per organism, tracking the generation's best as it goes.
+    The selection operators here then only ever read the cached array.
+    Roulette and rank selection build an AliasTable once per call (O(N), plus one sort for
+    ranks) and then draw each parent in O(1).
+    Elite selection uses partial selection (see TopK.h) to pick the top e_count in O(N);
+    EliteSelectByKey does the same for any other per-organism key (e.g. number of ones vs.
+    number of zeros when looking for the best of each, like best_ones/best_zeros in
+    PopulationManager_TubeSettler).
+
+    Organisms must not change between Evaluate() and selection (i.e. evaluate after
+    MutatePop, select before Update).
+*/
+
+#ifndef FITNESSCACHE_H
+#define FITNESSCACHE_H
+
+#include <functional>
+#include <algorithm>
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+#include "AliasTable.h"
+#include "TopK.h"
+
+template <typename ORG>
+class FitnessCache {
+  private:
+    emp::vector<double> fitnesses;
+    int best_id;
+    double best_fitness;
+
+    AliasTable alias_table;
+    emp::vector<double> weights;  // Scratch space for building alias tables.
+    emp::vector<int> order;       // Scratch space for ranking.
+    emp::vector<double> keys;     // Scratch space for elite-by-key.
+    emp::vector<int> elite_ids;
+
+    template <typename WORLD>
+    void InsertElites(WORLD &world, int copy_count) {
+      for (int id : elite_ids) world.InsertBirth(world[id], id, copy_count);
+    }
+
+    template <typename WORLD>
+    void SampleBirths(WORLD &world, emp::Random &random, int count) {
+      for (int i = 0; i < count; i++) {
+        const int parent_id = alias_table.Sample(random);
+        world.InsertBirth(world[parent_id], parent_id, 1);
+      }
+    }
+
+  public:
+    using fit_fun_t = std::function<double(ORG *)>;
+
+    FitnessCache() : best_id(-1), best_fitness(0.0) { ; }
+
+    int GetSize() const { return (int) fitnesses.size(); }
+    double GetFitness(int id) const { emp_assert(id >= 0 && id < GetSize()); return fitnesses[id]; }
+    const emp::vector<double> & GetFitnesses() const { return fitnesses; }
+    int GetBestID() const { return best_id; }
+    double GetBestFitness() const { return best_fitness; }
+
+    // Evaluate every organism in world exactly once. Ties for best go to the lowest ID.
+    template <typename WORLD>
+    void Evaluate(WORLD &world, const fit_fun_t &fit_fun) {
+      const int pop_size = world.GetSize();
+      fitnesses.resize(pop_size);
+      best_id = -1;
+      for (int i = 0; i < pop_size; i++) {
+        fitnesses[i] = fit_fun(&world[i]);
+        if (best_id == -1 || fitnesses[i] > fitnesses[best_id]) best_id = i;
+      }
+      best_fitness = (best_id == -1) ? 0.0 : fitnesses[best_id];
+    }
+
+    // Same, but let a population-level evaluator (e.g. ParallelPop) fill in the fitnesses and
+    // find the best.
+    template <typename WORLD, typename EVALUATOR>
+    void Evaluate(WORLD &world, const fit_fun_t &fit_fun, EVALUATOR &evaluator) {
+      best_id = evaluator.EvaluatePop(world, fit_fun, fitnesses);
+      best_fitness = (best_id == -1) ? 0.0 : fitnesses[best_id];
+    }
+
+    // Run tourny_count tournaments of size t_size on the cached fitnesses. Each winner is
+    // inserted (as a birth) into world's next generation.
+    template <typename WORLD>
+    void TournamentSelect(WORLD &world, emp::Random &random, int t_size, int tourny_count = 1) {
+      const int pop_size = GetSize();
+      emp_assert(pop_size == world.GetSize());
+      emp_assert(t_size > 0 && t_size <= pop_size);
+      for (int T = 0; T < tourny_count; T++) {
+        int win_id = random.GetInt(pop_size);
+        for (int i = 1; i < t_size; i++) {
+          const int id = random.GetInt(pop_size);
+          if (fitnesses[id] > fitnesses[win_id]) win_id = id;
+        }
+        world.InsertBirth(world[win_id], win_id, 1);
+      }
+    }
+
+    // Fitness-proportionate (roulette wheel) selection. Fitnesses must be non-negative; if
+    // they are all zero, parents are drawn uniformly.
+    template <typename WORLD>
+    void RouletteSelect(WORLD &world, emp::Random &random, int count = 1) {
+      emp_assert(GetSize() == world.GetSize());
+      alias_table.Build(fitnesses);
+      SampleBirths(world, random, count);
+    }
+
+    // Linear rank selection: the worst organism gets weight (2 - pressure), the best gets
+    // weight pressure (1.0 <= pressure <= 2.0). Tied organisms share their average rank.
+    template <typename WORLD>
+    void RankSelect(WORLD &world, emp::Random &random, int count = 1, double pressure = 2.0) {
+      const int pop_size = GetSize();
+      emp_assert(pop_size == world.GetSize());
+      emp_assert(pressure >= 1.0 && pressure <= 2.0);
+      order.resize(pop_size);
+      for (int i = 0; i < pop_size; i++) order[i] = i;
+      std::sort(order.begin(), order.end(),
+                [this](int a, int b) { return fitnesses[a] < fitnesses[b]; });
+      weights.resize(pop_size);
+      const double step = (pop_size > 1) ? 2.0 * (pressure - 1.0) / (pop_size - 1) : 0.0;
+      int run_start = 0;
+      while (run_start < pop_size) {
+        int run_end = run_start + 1;
+        while (run_end < pop_size && fitnesses[order[run_end]] == fitnesses[order[run_start]]) run_end++;
+        const double avg_rank = (run_start + run_end - 1) / 2.0;
+        for (int r = run_start; r < run_end; r++) weights[order[r]] = (2.0 - pressure) + step * avg_rank;
+        run_start = run_end;
+      }
+      alias_table.Build(weights);
+      SampleBirths(world, random, count);
+    }
+
+    // Insert copy_count copies of each of the e_count most fit organisms (best first).
+    template <typename WORLD>
+    void EliteSelect(WORLD &world, int e_count = 1, int copy_count = 1) {
+      emp_assert(GetSize() == world.GetSize());
+      emp_assert(e_count > 0 && e_count <= GetSize());
+      FindTopK(fitnesses, e_count, elite_ids, order);
+      InsertElites(world, copy_count);
+    }
+
+    // Same as EliteSelect, but rank organisms by key_fun instead of by cached fitness.
+    // key_fun is called exactly once per organism.
+    template <typename WORLD>
+    void EliteSelectByKey(WORLD &world, const fit_fun_t &key_fun, int e_count = 1, int copy_count = 1) {
+      const int pop_size = world.GetSize();
+      emp_assert(e_count > 0 && e_count <= pop_size);
+      keys.resize(pop_size);
+      for (int i = 0; i < pop_size; i++) keys[i] = key_fun(&world[i]);
+      FindTopK(keys, e_count, elite_ids, order);
+      InsertElites(world, copy_count);
+    }
+};
+
+#endif
@@ -0,0 +1,35 @@
+/*
+  Selection/TopK.h
+    Partial selection helpers: find the k largest keys without fully ordering everything.
+    std::nth_element partitions the top k to the front in O(N); only those k are then sorted
+    (O(k log k)) so results come back best-first, ties broken by lowest ID.
+*/
+
+#ifndef TOPK_H
+#define TOPK_H
+
+#include <algorithm>
+
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+// Fill top_ids with the IDs of the k largest entries of keys, best first.
+// (ids is scratch space; pass the same vector in each generation to avoid reallocating.)
+inline void FindTopK(const emp::vector<double> &keys, int k, emp::vector<int> &top_ids, emp::vector<int> &ids) {
+  const int N = (int) keys.size();
+  emp_assert(k >= 0);
+  k = std::min(k, N);
+  ids.resize(N);
+  for (int i = 0; i < N; i++) ids[i] = i;
+  auto better = [&keys](int a, int b) { return keys[a] > keys[b] || (keys[a] == keys[b] && a < b); };
+  if (k < N) std::nth_element(ids.begin(), ids.begin() + k, ids.end(), better);
+  std::sort(ids.begin(), ids.begin() + k, better);
+  top_ids.assign(ids.begin(), ids.begin() + k);
+}
+
+inline void FindTopK(const emp::vector<double> &keys, int k, emp::vector<int> &top_ids) {
+  emp::vector<int> ids;
+  FindTopK(keys, k, top_ids, ids);
+}
+
+#endif
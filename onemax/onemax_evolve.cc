@@ -2,6 +2,12 @@
 #include <iostream>
 #include <sstream>
 #include <functional>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <memory>
 
 #include "../../Empirical/tools/BitVector.h"
 #include "../../Empirical/tools/Random.h"
@@ -10,6 +16,15 @@
 //#include "../../Empirical/evo/StatsManager.h"
 
 #include "Organisms/OneMaxOrganism.h"
+#include "Selection/FitnessCache.h"
+#include "Fitness/NKLandscape.h"
+#include "Fitness/SiteFitness.h"
+#include "Fitness/IncrementalFitness.h"
+#include "Fitness/FitnessMemo.h"
+#include "../shared/parallel/ThreadPool.h"
+#include "Parallel/ParallelPop.h"
+#include "Checkpoint/PopulationCheckpoint.h"
+#include "../shared/stats/StatsWriter.h"
 
 ///////////////////
 // Notes: How do I setup mutate on birth?
@@ -17,42 +32,114 @@
 ///////////////////
 
 
-int main() {
-  // Initialize random num generator
-  emp::Random random;
+enum class SelectionMode { TOURNAMENT, ROULETTE, RANK };
+
+int main(int argc, char *argv[]) {
+  // Which selection scheme and landscape, how many threads, and what seed?
+  // (onemax_evolve [tournament|roulette|rank] [onemax|nk] [num_threads] [random_seed] [checkpoint_file])
+  // Results for a given seed do not depend on the number of threads.
+  // With a checkpoint file, the run is saved there every CHECKPOINT_INTERVAL generations and at
+  // the end; if the file already exists, the run picks up from it (with the seed it was saved
+  // with) and carries on to UPDATES generations.
+  // Every RESOLUTION generations (see StatsConfig.cfg), and for the final generation, the best
+  // and mean fitness of the mutated population are printed (by a background thread; see
+  // shared/stats/StatsWriter.h).
+  SelectionMode selection_mode = SelectionMode::TOURNAMENT;
+  if (argc > 1) {
+    const std::string mode(argv[1]);
+    if (mode == "roulette") selection_mode = SelectionMode::ROULETTE;
+    else if (mode == "rank") selection_mode = SelectionMode::RANK;
+    else if (mode != "tournament") {
+      std::cerr << "Unknown selection mode: " << mode << " (expected tournament, roulette or rank)" << std::endl;
+      return 1;
+    }
+  }
+  bool use_nk = false;
+  if (argc > 2) {
+    const std::string landscape(argv[2]);
+    if (landscape == "nk") use_nk = true;
+    else if (landscape != "onemax") {
+      std::cerr << "Unknown landscape: " << landscape << " (expected onemax or nk)" << std::endl;
+      return 1;
+    }
+  }
+  const int num_threads = (argc > 3) ? std::atoi(argv[3]) : (int) std::max(1u, std::thread::hardware_concurrency());
+  if (num_threads < 1) {
+    std::cerr << "Need at least one thread." << std::endl;
+    return 1;
+  }
+  // Initialize random num generator (a negative seed means seed from the clock)
+  emp::Random random((argc > 4) ? std::atoi(argv[4]) : -1);
   const int POPULATION_SIZE = 1000;
   const int GENOME_LENGTH = 50;
   const float POINT_MUTATION_RATE = 0.01;
   const int UPDATES = 150;
+  const int NK_K = 4;
+  const int CHECKPOINT_INTERVAL = 10;
+
+  // Resuming? The NK landscape is drawn from the seed, so go back to the saved seed before
+  // building it (the generator's saved state is restored once everything is built).
+  const std::string checkpoint_file = (argc > 5) ? argv[5] : "";
+  std::unique_ptr<MappedCheckpoint> checkpoint;
+  ByteReader checkpoint_reader(nullptr, 0);
+  if (checkpoint_file != "" && std::ifstream(checkpoint_file)) {
+    checkpoint.reset(new MappedCheckpoint(checkpoint_file, CHECKPOINT_KIND::ONEMAX, ONEMAX_CHECKPOINT_VERSION));
+    if (!checkpoint->IsOK()) return 1;
+    checkpoint_reader = checkpoint->GetReader();
+    const SelectionMode saved_mode = (SelectionMode) checkpoint_reader.Read<int>();
+    const bool saved_nk = checkpoint_reader.Read<bool>();
+    const int saved_seed = checkpoint_reader.Read<int>();
+    if (saved_mode != selection_mode || saved_nk != use_nk) {
+      std::cerr << "Checkpoint " << checkpoint_file << " was saved with a different selection mode or landscape." << std::endl;
+      return 1;
+    }
+    random.ResetSeed(saved_seed);
+  }
+  if (checkpoint_file != "" && use_nk && random.GetSeed() <= 0) {
+    std::cerr << "NK runs need an explicit random_seed to be checkpointed (the landscape is drawn from it)." << std::endl;
+    return 1;
+  }
 
   // Build the world
   emp::evo::World<OneMaxOrganism, emp::evo::PopEA> world(random, "OneMaxWorld");
 
-  std::function<bool(OneMaxOrganism *, emp::Random &)> mut_fun = [POINT_MUTATION_RATE](OneMaxOrganism *org, emp::Random &random) -> bool {
-    /* With some probability (point mutation rate), flip bits. */
-    bool mutated = false;
-    for (int i = 0; i < org->genome.GetSize(); i++) {
-      if (random.P(POINT_MUTATION_RATE)) {
-        org->genome[i] = !org->genome[i];
-        mutated = true;
-      }
-    }
-    return mutated;
-  };
+  // Fitness is cached on each organism: offspring inherit their parent's fitness and
+  // mutations only apply the change from the flipped sites (see Fitness/IncrementalFitness.h).
+  // The NK landscape is only built (and drawn from random) for NK runs, so OneMax runs keep
+  // their random number stream.
+  // From-scratch evaluations (new organisms and periodic refreshes) go through a genotype
+  // memo (see Fitness/FitnessMemo.h).
+  FitnessMemo<OneMaxOrganism> fit_memo;
+  OneMaxFitness onemax_fitness;
+  IncrementalFitness<OneMaxOrganism, OneMaxFitness> onemax_incremental(onemax_fitness, POINT_MUTATION_RATE);
+  onemax_incremental.SetEvalFun(fit_memo.Wrap(onemax_incremental.GetEvalFun()));
+  std::unique_ptr<NKLandscape> nk_landscape;
+  std::unique_ptr<IncrementalFitness<OneMaxOrganism, NKLandscape> > nk_incremental;
+  if (use_nk) {
+    nk_landscape.reset(new NKLandscape(GENOME_LENGTH, NK_K, random));
+    nk_incremental.reset(new IncrementalFitness<OneMaxOrganism, NKLandscape>(*nk_landscape, POINT_MUTATION_RATE));
+    nk_incremental->SetEvalFun(fit_memo.Wrap(nk_incremental->GetEvalFun()));
+  }
+
+  std::function<bool(OneMaxOrganism *, emp::Random &)> mut_fun = use_nk ? nk_incremental->GetMutFun() : onemax_incremental.GetMutFun();
   world.SetDefaultMutateFun(mut_fun);
 
-  std::function<double(OneMaxOrganism *)> fit_fun = [](OneMaxOrganism *org) -> double {
-    return (double) org->genome.CountOnes();
-  };
+  std::function<double(OneMaxOrganism *)> fit_fun = use_nk ? nk_incremental->GetFitFun() : onemax_incremental.GetFitFun();
   world.SetDefaultFitnessFun(fit_fun);
 
-  emp::LinkSignal("OneMaxWorld::on-update", []() {
-    std::cout << "OneMaxWorld : on update signal" << std::endl;
-  });
   // Initialize the population
-  for (int p = 0; p < POPULATION_SIZE; p++) {
-    OneMaxOrganism baby_org(GENOME_LENGTH);
-    world.Insert(baby_org);
+  if (checkpoint) {
+    if (!ReadRandom(checkpoint_reader, random) || !LoadPopulation(checkpoint_reader, world) || !checkpoint_reader.AtEnd()) {
+      std::cerr << "Could not load checkpoint " << checkpoint_file << ": payload does not match this version" << std::endl;
+      return 1;
+    }
+    checkpoint.reset();
+    std::cout << "Resumed from " << checkpoint_file << " at generation " << world.update << std::endl;
+  } else {
+    for (int p = 0; p < POPULATION_SIZE; p++) {
+      OneMaxOrganism baby_org(GENOME_LENGTH);
+      world.Insert(baby_org);
+    }
   }
   // Test all operators
   // std::cout << (world[0] == world[1]) << std::endl;
@@ -81,24 +168,53 @@ int main() {
   // exit(0);
   //std::cout << ss;
   // Evolution!
-  for (int ud = 1; ud <= UPDATES; ud++) {
+  ThreadPool thread_pool(num_threads);
+  ParallelPop<OneMaxOrganism> par_pop(thread_pool);
+  FitnessCache<OneMaxOrganism> fit_cache;
+  StatsConfig stats_config;
+  stats_config.Read("StatsConfig.cfg");
+  StatsWriter stats(stats_config, { "best_fitness", "mean_fitness" });
+  // Each generation is evaluated once, right after it is mutated (also finding its best org);
+  // the next generation's parents are then selected from that same cache.
+  fit_cache.Evaluate(world, fit_fun, par_pop);
+  for (int ud = world.update + 1; ud <= UPDATES; ud++) {
     int tourny_size = 4;
-    // Run a tournament for every slot in next population
-    world.TournamentSelect(tourny_size, world.GetSize());
+    // Select parents for every slot in next population
+    switch (selection_mode) {
+      case SelectionMode::TOURNAMENT:
+        fit_cache.TournamentSelect(world, random, tourny_size, world.GetSize());
+        break;
+      case SelectionMode::ROULETTE:
+        fit_cache.RouletteSelect(world, random, world.GetSize());
+        break;
+      case SelectionMode::RANK:
+        fit_cache.RankSelect(world, random, world.GetSize());
+        break;
+    }
     // Trigger the next generation (call: world.Update())
     world.Update();
     // Mutate the new population
-    world.MutatePop();
-    // Look at the population
-    int most_fit = 0;
-    for (int i = 0; i < world.GetSize(); i++) {
-      if (world[i] >= world[most_fit]) most_fit = i;
+    par_pop.MutatePop(world, random, mut_fun);
+    fit_cache.Evaluate(world, fit_fun, par_pop);
+    // Sample the generation just made (always including the last one).
+    if (stats.IsSampleUpdate(ud) || ud == UPDATES) {
+      double total_fitness = 0.0;
+      for (double fitness : fit_cache.GetFitnesses()) total_fitness += fitness;
+      stats.Begin(ud).Add(fit_cache.GetBestFitness()).Add(total_fitness / fit_cache.GetSize()).Push();
+    }
+    // Save a checkpoint (seed first, so a resumed run can rebuild the landscape).
+    if (checkpoint_file != "" && (ud % CHECKPOINT_INTERVAL == 0 || ud == UPDATES)) {
+      stats.Flush();
+      ByteWriter writer;
+      writer.Write((int) selection_mode).Write(use_nk).Write(random.GetSeed());
+      WriteRandom(writer, random);
+      SavePopulation(writer, world);
+      if (!WriteCheckpointFile(checkpoint_file, CHECKPOINT_KIND::ONEMAX, ONEMAX_CHECKPOINT_VERSION, writer.GetBuffer())) return 1;
     }
-    // Get max fitness from population
-    std::cout << "Generation: " << ud << " Best org: ";
-    world[most_fit].Print();
-    //std::cout << "\tMost fit genome: "; world[most_fit].Print();
   }
+  stats.Close();
+  std::cout << "Fitness cache hits: " << fit_memo.GetHits() << " Misses: " << fit_memo.GetMisses()
+            << " Evictions: " << fit_memo.GetEvictions() << std::endl;
 
   return 0;
 }
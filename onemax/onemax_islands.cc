@@ -0,0 +1,191 @@
+/*
+  onemax_islands.cc
+    Island-model OneMax. NUM_ISLANDS separate World<OneMaxOrganism, PopEA> populations each
+    evolve on their own thread with their own random number stream. Every MIGRATION_INTERVAL
+    generations, each island sends copies of its best organisms to the next island in a ring
+    (through lock-free single-producer/single-consumer queues).
+
+    Usage: onemax_islands [num_islands] [random_seed] [deterministic (0/1)]
+
+    * Deterministic mode: an island that is due migrants waits for them to arrive, so a run
+      is fully determined by (seed, number of islands).
+    * Otherwise, islands never wait: migrants are taken whenever they happen to show up.
+
+    Per-generation stats are written by each island into its own slot; the main thread prints
+    a generation once every island has reported it. No locks anywhere, except inside the
+    fitness memo all islands evaluate through (see Fitness/FitnessMemo.h; it is sharded, and
+    migrants' genomes are often already in it).
+*/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+#include "../../Empirical/tools/BitVector.h"
+#include "../../Empirical/tools/Random.h"
+#include "../../Empirical/tools/vector.h"
+#include "../../Empirical/tools/assert.h"
+
+#include "../../Empirical/evo/World.h"
+
+#include "Organisms/OneMaxOrganism.h"
+#include "Fitness/FitnessMemo.h"
+#include "Selection/FitnessCache.h"
+#include "Selection/TopK.h"
+#include "../shared/parallel/SPSCQueue.h"
+#include "Parallel/DeriveSeed.h"
+
+const int POPULATION_SIZE = 1000;     // Per island.
+const int GENOME_LENGTH = 50;
+const double POINT_MUTATION_RATE = 0.01;
+const int UPDATES = 150;
+const int TOURNY_SIZE = 4;
+const int MIGRATION_INTERVAL = 10;    // Generations between migrations.
+const int NUM_MIGRANTS = 5;           // Organisms sent per migration.
+
+struct Migrant {
+  int generation;
+  emp::BitVector genome;
+};
+
+struct IslandStats {
+  double best_fitness;
+  double mean_fitness;
+};
+
+class Archipelago {
+  private:
+    using World_t = emp::evo::World<OneMaxOrganism, emp::evo::PopEA>;
+
+    const int num_islands;
+    const int seed;
+    const bool deterministic;
+
+    // Island i emigrates into queues[i]; island (i + 1) % num_islands immigrates from it.
+    emp::vector<std::unique_ptr<SPSCQueue<Migrant>>> queues;
+    // stats[gen * num_islands + island]; reported[gen] counts islands done with gen.
+    emp::vector<IslandStats> stats;
+    std::unique_ptr<std::atomic<int>[]> reported;
+    FitnessMemo<OneMaxOrganism> fit_memo;   // Shared by every island.
+
+    void RunIsland(int island_id) {
+      emp::Random random(DeriveSeed(seed, island_id));   // Each island gets its own stream.
+      World_t world(random, "OneMaxIsland" + std::to_string(island_id));
+      std::function<bool(OneMaxOrganism *, emp::Random &)> mut_fun = [](OneMaxOrganism *org, emp::Random &random) -> bool {
+        bool mutated = false;
+        for (int i = 0; i < org->genome.GetSize(); i++) {
+          if (random.P(POINT_MUTATION_RATE)) {
+            org->genome[i] = !org->genome[i];
+            mutated = true;
+          }
+        }
+        return mutated;
+      };
+      world.SetDefaultMutateFun(mut_fun);
+      std::function<double(OneMaxOrganism *)> fit_fun = fit_memo.Wrap([](OneMaxOrganism *org) -> double {
+        return (double) org->genome.CountOnes();
+      });
+      world.SetDefaultFitnessFun(fit_fun);
+      for (int p = 0; p < POPULATION_SIZE; p++) world.Insert(OneMaxOrganism(GENOME_LENGTH));
+
+      SPSCQueue<Migrant> &out_queue = *queues[island_id];
+      SPSCQueue<Migrant> &in_queue = *queues[(island_id + num_islands - 1) % num_islands];
+      FitnessCache<OneMaxOrganism> fit_cache;
+      emp::vector<int> emigrant_ids;
+      Migrant migrant;
+
+      for (int ud = 1; ud <= UPDATES; ud++) {
+        fit_cache.Evaluate(world, fit_fun);
+        // Report this generation.
+        double total_fitness = 0.0;
+        for (double fitness : fit_cache.GetFitnesses()) total_fitness += fitness;
+        stats[(ud - 1) * num_islands + island_id] = { fit_cache.GetBestFitness(), total_fitness / world.GetSize() };
+        reported[ud - 1].fetch_add(1, std::memory_order_release);
+
+        const bool migrate = (num_islands > 1) && (ud % MIGRATION_INTERVAL == 0);
+        // Send copies of our best to the next island.
+        if (migrate) {
+          FindTopK(fit_cache.GetFitnesses(), NUM_MIGRANTS, emigrant_ids);
+          for (int id : emigrant_ids) {
+            migrant.generation = ud;
+            migrant.genome = world[id].genome;
+            // Queues hold several migrations' worth; if a slow neighbor lets one fill up,
+            // wait in deterministic mode and drop the migrant otherwise.
+            while (!out_queue.Push(migrant) && deterministic) std::this_thread::yield();
+          }
+        }
+
+        fit_cache.TournamentSelect(world, random, TOURNY_SIZE, world.GetSize());
+        world.Update();
+        world.MutatePop();
+
+        // Migrants replace random members of the new generation.
+        if (migrate) {
+          int received = 0;
+          while (true) {
+            if (in_queue.Pop(migrant)) {
+              emp_assert(!deterministic || migrant.generation == ud);
+              world[random.GetInt(world.GetSize())].genome = migrant.genome;
+              received++;
+              if (deterministic && received == NUM_MIGRANTS) break;
+            } else if (deterministic) {
+              std::this_thread::yield();
+            } else {
+              break;
+            }
+          }
+        }
+      }
+    }
+
+  public:
+    Archipelago(int _num_islands, int _seed, bool _deterministic)
+      : num_islands(_num_islands), seed(_seed), deterministic(_deterministic),
+        stats(UPDATES * _num_islands), reported(new std::atomic<int>[UPDATES])
+    {
+      for (int i = 0; i < num_islands; i++) {
+        queues.emplace_back(new SPSCQueue<Migrant>(4 * NUM_MIGRANTS));
+      }
+      for (int ud = 0; ud < UPDATES; ud++) reported[ud].store(0);
+    }
+
+    void Run() {
+      emp::vector<std::thread> threads;
+      for (int i = 0; i < num_islands; i++) threads.emplace_back(&Archipelago::RunIsland, this, i);
+      // Print each generation as soon as every island has reported it.
+      for (int ud = 1; ud <= UPDATES; ud++) {
+        while (reported[ud - 1].load(std::memory_order_acquire) < num_islands) std::this_thread::yield();
+        double best = 0.0;
+        double mean = 0.0;
+        for (int i = 0; i < num_islands; i++) {
+          const IslandStats &island_stats = stats[(ud - 1) * num_islands + i];
+          if (i == 0 || island_stats.best_fitness > best) best = island_stats.best_fitness;
+          mean += island_stats.mean_fitness / num_islands;
+        }
+        std::cout << "Generation: " << ud << " Best fitness: " << best << " Mean fitness: " << mean << std::endl;
+      }
+      for (auto &thread : threads) thread.join();
+      std::cout << "Fitness cache hits: " << fit_memo.GetHits() << " Misses: " << fit_memo.GetMisses()
+                << " Evictions: " << fit_memo.GetEvictions() << std::endl;
+    }
+};
+
+int main(int argc, char *argv[]) {
+  const int num_islands = (argc > 1) ? std::atoi(argv[1]) : (int) std::max(1u, std::thread::hardware_concurrency());
+  const int random_seed = (argc > 2) ? std::atoi(argv[2]) : 1;
+  const bool deterministic = (argc > 3) ? (std::atoi(argv[3]) != 0) : true;
+  if (num_islands < 1) {
+    std::cerr << "Need at least one island." << std::endl;
+    return 1;
+  }
+  std::cout << "Islands: " << num_islands << " Random seed: " << random_seed
+            << " Deterministic: " << deterministic << std::endl;
+  Archipelago archipelago(num_islands, random_seed, deterministic);
+  archipelago.Run();
+  return 0;
+}
@@ -0,0 +1,64 @@
+/*
+  onemax_matrix_evolve.cc
+    OneMax, but with the whole population stored in a single bit matrix
+    (see PopulationManagers/PopulationManager_BitMatrix.h). Each generation reports how many
+    distinct genotypes there are, from the population manager's census.
+*/
+
+#include <iostream>
+
+#include "../../Empirical/tools/Random.h"
+#include "../../Empirical/tools/vector.h"
+
+#include "../../Empirical/evo/World.h"
+
+#include "Organisms/OneMaxOrganism.h"
+#include "PopulationManagers/PopulationManager_BitMatrix.h"
+
+int main() {
+  // Initialize random num generator
+  emp::Random random;
+  const int POPULATION_SIZE = 1000;
+  const int GENOME_LENGTH = 50;
+  const double POINT_MUTATION_RATE = 0.01;
+  const int UPDATES = 150;
+  const int TOURNY_SIZE = 4;
+
+  // Build the world
+  using MatrixPop_t = emp::evo::PopulationManager_BitMatrix<OneMaxOrganism>;
+  emp::evo::World<OneMaxOrganism, MatrixPop_t> world(random, "OneMaxMatrixWorld");
+  world.ConfigPop(GENOME_LENGTH);
+
+  // Initialize the population
+  for (int p = 0; p < POPULATION_SIZE; p++) {
+    OneMaxOrganism baby_org(GENOME_LENGTH);
+    world.Insert(baby_org);
+  }
+
+  // Evolution!
+  emp::vector<double> fitnesses;
+  for (int ud = 1; ud <= UPDATES; ud++) {
+    // Evaluate every genome once, straight off the matrix.
+    world.popM.EvaluateOnes(fitnesses);
+    // Run a tournament for every slot in next population (records parent rows only).
+    world.popM.TournamentSelect(fitnesses, TOURNY_SIZE, world.GetSize());
+    // Trigger the next generation (copies parent rows into the next buffer).
+    world.Update();
+    // Mutate the new population.
+    world.popM.MutatePop(POINT_MUTATION_RATE);
+    // Look at the population
+    int most_fit = 0;
+    int most_ones = -1;
+    for (int i = 0; i < world.GetSize(); i++) {
+      const int ones = world.popM.CountOnes(i);
+      if (ones > most_ones) { most_ones = ones; most_fit = i; }
+    }
+    const auto &census = world.popM.GetCensus();
+    std::cout << "Generation: " << ud << " Genotypes: " << census.GetRichness()
+              << " (entropy " << census.GetEntropy() << ", dominant x" << census.GetDominantCount() << ")"
+              << " Best org: ";
+    world[most_fit].Print();
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+/*
+  onemax_steady_state.cc
+    Asynchronous steady-state OneMax (see Parallel/SteadyStateEA.h). Worker threads breed
+    continuously; there are no generations, so progress is reported every REPORT_INTERVAL
+    births, along with throughput in births per second and genotype diversity (how many
+    distinct genomes, their entropy, and how many organisms carry the most common one).
+
+    Usage: onemax_steady_state [num_threads] [total_births] [random_seed]
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <functional>
+
+#include "../../Empirical/tools/Random.h"
+
+#include "Organisms/OneMaxOrganism.h"
+#include "Parallel/SteadyStateEA.h"
+#include "Fitness/FitnessMemo.h"
+
+const int POPULATION_SIZE = 1000;
+const int GENOME_LENGTH = 50;
+const double POINT_MUTATION_RATE = 0.01;
+const int TOURNY_SIZE = 4;
+const uint64_t REPORT_INTERVAL = 10000;
+
+int main(int argc, char *argv[]) {
+  const int num_threads = (argc > 1) ? std::atoi(argv[1]) : (int) std::max(1u, std::thread::hardware_concurrency());
+  const uint64_t total_births = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : POPULATION_SIZE * 150;
+  const int random_seed = (argc > 3) ? std::atoi(argv[3]) : 1;
+  if (num_threads < 1) {
+    std::cerr << "Need at least one thread." << std::endl;
+    return 1;
+  }
+
+  std::function<bool(OneMaxOrganism *, emp::Random &)> mut_fun = [](OneMaxOrganism *org, emp::Random &random) -> bool {
+    /* With some probability (point mutation rate), flip bits. */
+    bool mutated = false;
+    for (int i = 0; i < org->genome.GetSize(); i++) {
+      if (random.P(POINT_MUTATION_RATE)) {
+        org->genome[i] = !org->genome[i];
+        mutated = true;
+      }
+    }
+    return mutated;
+  };
+  std::function<double(OneMaxOrganism *)> fit_fun = [](OneMaxOrganism *org) -> double {
+    return (double) org->genome.CountOnes();
+  };
+
+  // Offspring often repeat genomes already seen; only evaluate new ones.
+  FitnessMemo<OneMaxOrganism> fit_memo;
+  SteadyStateEA<OneMaxOrganism> ea(fit_memo.Wrap(fit_fun), mut_fun, TOURNY_SIZE);
+  for (int p = 0; p < POPULATION_SIZE; p++) ea.Insert(OneMaxOrganism(GENOME_LENGTH));
+  ea.SetReport(REPORT_INTERVAL, [](const SteadyStateEA<OneMaxOrganism>::Report &report) {
+    std::cout << "Births: " << report.births
+              << " Best fitness: " << report.best_fitness
+              << " Mean fitness: " << report.mean_fitness
+              << " Births/sec: " << report.births_per_sec
+              << " Genotypes: " << report.genotypes
+              << " Entropy: " << report.genotype_entropy
+              << " Dominant: " << report.dominant_count << std::endl;
+  });
+
+  std::cout << "Threads: " << num_threads << " Random seed: " << random_seed << std::endl;
+  const double births_per_sec = ea.Run(total_births, num_threads, random_seed);
+  std::cout << "Total births: " << ea.GetBirths() << " Births/sec: " << births_per_sec << std::endl;
+  std::cout << "Fitness cache hits: " << fit_memo.GetHits() << " Misses: " << fit_memo.GetMisses()
+            << " Evictions: " << fit_memo.GetEvictions() << std::endl;
+  return 0;
+}
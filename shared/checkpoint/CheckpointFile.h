@@ -0,0 +1,148 @@
+/*
+  shared/checkpoint/CheckpointFile.h
+    Defines the file every checkpoint (Pt1, Pt4 and OneMax) is stored in. Payloads are packed
+    and unpacked with ByteWriter / ByteReader (see shared/serialize/Bytes.h).
+
+    A checkpoint file is a fixed header followed by the payload:
+      magic "EMPCKPT" | format version | kind | payload size | payload checksum (FNV-1a)
+    The kind says which experiment wrote the file and the version which layout it used, so
+    a loader can refuse anything it does not understand; the checksum catches truncated or
+    corrupted files.
+
+    * WriteCheckpointFile writes to a temporary file and renames it into place, so a crash
+      part way through never clobbers the last good checkpoint.
+    * MappedCheckpoint maps a checkpoint file into memory (mmap) and checks its header;
+      GetReader() then reads values straight out of the mapping.
+    * WriteRandom / ReadRandom save and restore the complete state of an emp::Random.
+    * Problems print a message and return false (like config.Read()).
+*/
+
+#ifndef CHECKPOINT_FILE_H
+#define CHECKPOINT_FILE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../serialize/Bytes.h"
+
+#include "../../../Empirical/tools/Random.h"
+#include "../../../Empirical/tools/assert.h"
+
+// Which experiment wrote a checkpoint.
+enum class CHECKPOINT_KIND : uint32_t { PT1 = 1, PT4 = 4, ONEMAX = 100 };
+
+struct CheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t kind;
+  uint64_t payload_size;
+  uint64_t checksum;
+};
+
+inline uint64_t CheckpointChecksum(const char *data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (uint8_t) data[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// The random number generator is saved as its raw bytes (it holds no pointers).
+inline void WriteRandom(ByteWriter &writer, const emp::Random &random) {
+  static_assert(std::is_trivially_copyable<emp::Random>::value, "emp::Random must be plain data to be checkpointed.");
+  writer.Write((uint32_t) sizeof(emp::Random));
+  writer.WriteBytes(&random, sizeof(emp::Random));
+}
+
+inline bool ReadRandom(ByteReader &reader, emp::Random &random) {
+  if (reader.Read<uint32_t>() != sizeof(emp::Random)) return false;
+  return reader.ReadBytes(&random, sizeof(emp::Random));
+}
+
+inline bool WriteCheckpointFile(const std::string &filename, CHECKPOINT_KIND kind, uint32_t version,
+                                const std::string &payload) {
+  CheckpointHeader header;
+  std::memcpy(header.magic, "EMPCKPT", sizeof(header.magic));
+  header.version = version;
+  header.kind = (uint32_t) kind;
+  header.payload_size = payload.size();
+  header.checksum = CheckpointChecksum(payload.data(), payload.size());
+
+  const std::string temp_filename = filename + ".tmp";
+  FILE *file = std::fopen(temp_filename.c_str(), "wb");
+  if (!file) {
+    std::cerr << "Could not open " << temp_filename << " for writing (" << std::strerror(errno) << ")" << std::endl;
+    return false;
+  }
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  ok = ok && (payload.size() == 0 || std::fwrite(payload.data(), payload.size(), 1, file) == 1);
+  ok = (std::fflush(file) == 0) && ok;
+  ok = (fsync(fileno(file)) == 0) && ok;
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok || std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    std::cerr << "Could not write checkpoint " << filename << " (" << std::strerror(errno) << ")" << std::endl;
+    std::remove(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+class MappedCheckpoint {
+  private:
+    void *mapping;
+    size_t mapping_size;
+    const CheckpointHeader *header;
+    bool ok;
+
+    bool Fail(const std::string &filename, const std::string &what) {
+      std::cerr << "Could not load checkpoint " << filename << ": " << what << std::endl;
+      return ok = false;
+    }
+
+  public:
+    // Map filename and check that it is a version 'version' checkpoint of the given kind.
+    MappedCheckpoint(const std::string &filename, CHECKPOINT_KIND kind, uint32_t version)
+      : mapping(MAP_FAILED), mapping_size(0), header(nullptr), ok(true)
+    {
+      const int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) { Fail(filename, std::strerror(errno)); return; }
+      struct stat file_stat;
+      if (fstat(fd, &file_stat) < 0) { Fail(filename, std::strerror(errno)); close(fd); return; }
+      mapping_size = (size_t) file_stat.st_size;
+      if (mapping_size >= sizeof(CheckpointHeader)) {
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+      close(fd);
+      if (mapping == MAP_FAILED) { Fail(filename, "file too short or could not be mapped"); return; }
+      header = static_cast<const CheckpointHeader *>(mapping);
+      if (std::memcmp(header->magic, "EMPCKPT", sizeof(header->magic)) != 0) Fail(filename, "not a checkpoint file");
+      else if (header->kind != (uint32_t) kind) Fail(filename, "checkpoint is from a different experiment");
+      else if (header->version != version) Fail(filename, "unsupported checkpoint version " + std::to_string(header->version));
+      else if (header->payload_size != mapping_size - sizeof(CheckpointHeader)) Fail(filename, "file is truncated");
+      else if (header->checksum != CheckpointChecksum(GetPayload(), header->payload_size)) Fail(filename, "checksum mismatch");
+    }
+    MappedCheckpoint(const MappedCheckpoint &) = delete;
+    MappedCheckpoint & operator=(const MappedCheckpoint &) = delete;
+
+    ~MappedCheckpoint() { if (mapping != MAP_FAILED) munmap(mapping, mapping_size); }
+
+    bool IsOK() const { return ok; }
+    const char * GetPayload() const { return static_cast<const char *>(mapping) + sizeof(CheckpointHeader); }
+    ByteReader GetReader() const {
+      emp_assert(ok);
+      return ByteReader(GetPayload(), (size_t) header->payload_size);
+    }
+};
+
+#endif
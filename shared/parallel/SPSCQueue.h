@@ -0,0 +1,61 @@
+/*
+  shared/parallel/SPSCQueue.h
+    Defines SPSCQueue, a bounded lock-free queue for exactly one producer thread and one
+    consumer thread (e.g. one OneMax island sending migrants to its neighbor, or a simulation
+    handing stats rows to a writer thread).
+    Push/Pop never block; they return false if the queue is full/empty.
+*/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+template <typename T>
+class SPSCQueue {
+  private:
+    emp::vector<T> slots;
+    const size_t capacity;          // One slot is always left empty to tell full from empty.
+    // Head and tail are padded onto separate cache lines so the two threads don't false-share.
+    char pad0[64];
+    std::atomic<size_t> head;   // Next slot to pop (owned by consumer).
+    char pad1[64];
+    std::atomic<size_t> tail;   // Next slot to push (owned by producer).
+    char pad2[64];
+
+  public:
+    SPSCQueue(size_t max_items)
+      : slots(max_items + 1), capacity(max_items + 1), head(0), tail(0)
+    { emp_assert(max_items > 0); }
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue & operator=(const SPSCQueue &) = delete;
+
+    // Producer only.
+    bool Push(const T &item) {
+      const size_t cur_tail = tail.load(std::memory_order_relaxed);
+      const size_t next_tail = (cur_tail + 1) % capacity;
+      if (next_tail == head.load(std::memory_order_acquire)) return false;  // Full.
+      slots[cur_tail] = item;
+      tail.store(next_tail, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer only.
+    bool Pop(T &item) {
+      const size_t cur_head = head.load(std::memory_order_relaxed);
+      if (cur_head == tail.load(std::memory_order_acquire)) return false;   // Empty.
+      item = slots[cur_head];
+      head.store((cur_head + 1) % capacity, std::memory_order_release);
+      return true;
+    }
+
+    // Approximate when called concurrently with Push/Pop.
+    bool IsEmpty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  shared/parallel/ThreadPool.h
+    Defines ThreadPool, a fixed set of worker threads for data-parallel loops.
+
+    ParallelFor(num_chunks, fun) calls fun(chunk) for every chunk in [0, num_chunks) and
+    returns once they are all done. Scheduling is static: thread t (the calling thread is
+    thread 0) runs chunks t, t + num_threads, t + 2 * num_threads, ... Which thread ran a
+    chunk should never matter to the result; anything random inside a chunk should draw from
+    a stream keyed by the chunk (or by the entity it is working on), not by the thread.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+class ThreadPool {
+  public:
+    using chunk_fun_t = std::function<void(int)>;
+
+  private:
+    const int num_threads;
+    emp::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable job_done;
+    const chunk_fun_t *job;     // Current job (only valid while a ParallelFor is running).
+    int job_chunks;
+    int job_id;                 // Incremented for every new job.
+    int workers_busy;
+    bool stopping;
+
+    void RunChunks(int thread_id, const chunk_fun_t &fun, int num_chunks) {
+      for (int chunk = thread_id; chunk < num_chunks; chunk += num_threads) fun(chunk);
+    }
+
+    void RunWorker(int thread_id) {
+      int last_job = 0;
+      while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        job_ready.wait(lock, [this, last_job]() { return stopping || job_id != last_job; });
+        if (stopping) return;
+        last_job = job_id;
+        const chunk_fun_t &fun = *job;
+        const int num_chunks = job_chunks;
+        lock.unlock();
+        RunChunks(thread_id, fun, num_chunks);
+        lock.lock();
+        if (--workers_busy == 0) job_done.notify_one();
+      }
+    }
+
+  public:
+    ThreadPool(int _num_threads)
+      : num_threads(_num_threads), job(nullptr), job_chunks(0), job_id(0), workers_busy(0), stopping(false)
+    {
+      emp_assert(num_threads > 0);
+      for (int t = 1; t < num_threads; t++) workers.emplace_back(&ThreadPool::RunWorker, this, t);
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+      }
+      job_ready.notify_all();
+      for (auto &worker : workers) worker.join();
+    }
+
+    int GetNumThreads() const { return num_threads; }
+
+    void ParallelFor(int num_chunks, const chunk_fun_t &fun) {
+      if (num_threads == 1 || num_chunks <= 1) {
+        for (int chunk = 0; chunk < num_chunks; chunk++) fun(chunk);
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        job = &fun;
+        job_chunks = num_chunks;
+        workers_busy = num_threads - 1;
+        job_id++;
+      }
+      job_ready.notify_all();
+      RunChunks(0, fun, num_chunks);
+      std::unique_lock<std::mutex> lock(mutex);
+      job_done.wait(lock, [this]() { return workers_busy == 0; });
+      job = nullptr;
+    }
+};
+
+#endif
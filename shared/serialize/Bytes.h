@@ -0,0 +1,104 @@
+/*
+  shared/serialize/Bytes.h
+    Defines ByteWriter and ByteReader, which pack values into (and out of) byte strings:
+    checkpoint payloads in every project (see shared/checkpoint/CheckpointFile.h), and Pt4's
+    event logs (events/EventLog.h) and shard messages (sharding/EntityCodec.h) all use them.
+
+    Values are copied byte for byte, so the bytes are only meant to be read back by the same
+    code on the same kind of machine. Bit vectors are packed 8 bits to a byte, after their size.
+    A read past the end returns zeros and marks the reader as failed (see IsOK()).
+*/
+
+#ifndef SERIALIZE_BYTES_H
+#define SERIALIZE_BYTES_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "../../../Empirical/tools/BitVector.h"
+
+class ByteWriter {
+  private:
+    std::string buffer;
+
+  public:
+    template <typename T>
+    ByteWriter & Write(const T &value) {
+      static_assert(std::is_trivially_copyable<T>::value, "ByteWriter can only write plain values.");
+      buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+      return *this;
+    }
+
+    ByteWriter & Write(const emp::BitVector &bits) {
+      const int num_bits = bits.GetSize();
+      Write(num_bits);
+      for (int byte = 0; byte < (num_bits + 7) / 8; byte++) {
+        uint8_t packed = 0;
+        for (int i = 0; i < 8 && byte * 8 + i < num_bits; i++) packed |= (uint8_t) bits.Get(byte * 8 + i) << i;
+        Write(packed);
+      }
+      return *this;
+    }
+
+    ByteWriter & WriteBytes(const void *data, size_t size) {
+      buffer.append(reinterpret_cast<const char *>(data), size);
+      return *this;
+    }
+
+    const std::string & GetBuffer() const { return buffer; }
+    void Clear() { buffer.clear(); }
+};
+
+class ByteReader {
+  private:
+    const char *data;
+    size_t size;
+    size_t pos;
+    bool failed;              // Set by any read past the end.
+
+    bool Take(size_t count) {
+      if (failed || pos + count > size) { failed = true; return false; }
+      return true;
+    }
+
+  public:
+    ByteReader(const char *_data, size_t _size) : data(_data), size(_size), pos(0), failed(false) { ; }
+    // Reads straight out of buffer, which must outlive the reader.
+    ByteReader(const std::string &buffer) : ByteReader(buffer.data(), buffer.size()) { ; }
+
+    template <typename T>
+    T Read() {
+      static_assert(std::is_trivially_copyable<T>::value, "ByteReader can only read plain values.");
+      T value;
+      std::memset(&value, 0, sizeof(T));
+      if (!Take(sizeof(T))) return value;
+      std::memcpy(&value, data + pos, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    void Read(emp::BitVector &bits) {
+      const int num_bits = Read<int>();
+      if (num_bits < 0 || !Take((num_bits + 7) / 8)) { failed = true; return; }
+      bits.Resize(num_bits);
+      for (int byte = 0; byte < (num_bits + 7) / 8; byte++) {
+        const uint8_t packed = Read<uint8_t>();
+        for (int i = 0; i < 8 && byte * 8 + i < num_bits; i++) bits.Set(byte * 8 + i, (packed >> i) & 1);
+      }
+    }
+
+    bool ReadBytes(void *out, size_t count) {
+      if (!Take(count)) return false;
+      std::memcpy(out, data + pos, count);
+      pos += count;
+      return true;
+    }
+
+    // Did every read so far fit?
+    bool IsOK() const { return !failed; }
+    bool AtEnd() const { return pos == size; }
+};
+
+#endif
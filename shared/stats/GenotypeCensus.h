@@ -0,0 +1,136 @@
+/*
+  shared/stats/GenotypeCensus.h
+    Defines GenotypeCensus, a running count of how many organisms carry each distinct genome.
+    The population's owner tells it about every organism that arrives (Add) or goes (Remove),
+    so nothing ever has to walk the population to answer:
+      GetRichness()         How many distinct genotypes are there?
+      GetEntropy()          Shannon entropy (in nats) of the genotype frequencies.
+      GetDominant()         The most common genome (ties go to any of them), and
+      GetDominantCount()    how many organisms carry it.
+    All of these are O(1); Add and Remove are O(1) on average (one hash lookup).
+
+    Entropy: with N organisms and c_g of genotype g, H = log N - (sum_g c_g log c_g) / N, so only
+    the sum needs to be kept up to date. The dominant genotype is found by keeping genotypes in
+    buckets by count (an organism arriving or going moves its genotype one bucket up or down).
+*/
+
+#ifndef GENOTYPE_CENSUS_H
+#define GENOTYPE_CENSUS_H
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include "../../../Empirical/tools/BitVector.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+// Hash of a genome's bits (equal genomes, equal hashes).
+struct GenomeHash {
+  uint64_t operator()(const emp::BitVector &genome) const {
+    uint64_t hash = 14695981039346656037ull ^ (uint64_t) genome.GetSize();
+    for (int word = 0; word < (genome.GetSize() + 31) / 32; word++) {
+      hash ^= genome.GetUInt(word);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+};
+
+template <typename GENOME = emp::BitVector, typename HASH = GenomeHash>
+class GenotypeCensus {
+  private:
+    struct Genotype {
+      int count;
+      int bucket_pos;   // Where this genotype is in by_count[count].
+    };
+    using table_t = std::unordered_map<GENOME, Genotype, HASH>;
+    using entry_t = typename table_t::value_type;
+
+    table_t genotypes;
+    emp::vector<emp::vector<entry_t*> > by_count;   // by_count[c] holds the genotypes with c organisms.
+    int num_orgs;
+    int max_count;
+    double sum_c_log_c;
+
+    static double CLogC(int c) { return (c > 1) ? c * std::log((double) c) : 0.0; }
+
+    void BucketInsert(entry_t *entry) {
+      const int count = entry->second.count;
+      if (count >= (int) by_count.size()) by_count.resize(count + 1);
+      entry->second.bucket_pos = (int) by_count[count].size();
+      by_count[count].push_back(entry);
+    }
+
+    // Swap the last genotype in the bucket into this one's place.
+    void BucketRemove(entry_t *entry) {
+      emp::vector<entry_t*> &bucket = by_count[entry->second.count];
+      entry_t *last = bucket.back();
+      bucket[entry->second.bucket_pos] = last;
+      last->second.bucket_pos = entry->second.bucket_pos;
+      bucket.pop_back();
+    }
+
+  public:
+    GenotypeCensus() : num_orgs(0), max_count(0), sum_c_log_c(0.0) { ; }
+
+    // An organism carrying genome has arrived.
+    void Add(const GENOME &genome) {
+      entry_t *entry = &*genotypes.emplace(genome, Genotype{0, -1}).first;
+      int &count = entry->second.count;
+      if (count > 0) BucketRemove(entry);
+      sum_c_log_c += CLogC(count + 1) - CLogC(count);
+      count++;
+      BucketInsert(entry);
+      num_orgs++;
+      if (count > max_count) max_count = count;
+    }
+
+    // An organism carrying genome has gone (it must have been added).
+    void Remove(const GENOME &genome) {
+      auto it = genotypes.find(genome);
+      emp_assert(it != genotypes.end() && it->second.count > 0);
+      entry_t *entry = &*it;
+      const int count = entry->second.count;
+      BucketRemove(entry);
+      sum_c_log_c += CLogC(count - 1) - CLogC(count);
+      num_orgs--;
+      if (count > 1) {
+        entry->second.count--;
+        BucketInsert(entry);
+      } else {
+        genotypes.erase(it);
+      }
+      // Only this genotype changed, and it is now one bucket down.
+      if (count == max_count && by_count[count].empty()) max_count--;
+    }
+
+    void Clear() {
+      genotypes.clear();
+      by_count.resize(0);
+      num_orgs = 0;
+      max_count = 0;
+      sum_c_log_c = 0.0;
+    }
+
+    int GetNumOrgs() const { return num_orgs; }
+    int GetRichness() const { return (int) genotypes.size(); }
+    int GetCount(const GENOME &genome) const {
+      auto it = genotypes.find(genome);
+      return (it == genotypes.end()) ? 0 : it->second.count;
+    }
+
+    double GetEntropy() const {
+      if (num_orgs == 0) return 0.0;
+      const double entropy = std::log((double) num_orgs) - sum_c_log_c / num_orgs;
+      return (entropy > 0.0) ? entropy : 0.0;   // Rounding can leave a uniform population just below 0.
+    }
+
+    int GetDominantCount() const { return max_count; }
+    const GENOME & GetDominant() const {
+      emp_assert(num_orgs > 0);
+      return by_count[max_count][0]->first;
+    }
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*
+  shared/stats/StatsWriter.h
+    Defines StatsConfig (the settings in StatsConfig.cfg) and StatsWriter, which writes one
+    row of stats every RESOLUTION updates without making the simulation wait on output.
+
+    The simulation thread hands each row (update plus up to MAX_STATS_COLUMNS numbers) to a
+    background writer thread through a lock-free queue (see shared/parallel/SPSCQueue.h); the
+    writer formats it (fields separated by DELIMITER) into a buffered stream. Push never blocks
+    and never loses a row: if the writer falls a whole queue behind, rows wait in an overflow
+    list on the simulation side and go into the queue (in order) as it frees up.
+    Flush (e.g. before a checkpoint) and Close (at exit; also called by the destructor) wait
+    until every row pushed so far is written and the stream flushed.
+*/
+
+#ifndef STATS_WRITER_H
+#define STATS_WRITER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../parallel/SPSCQueue.h"
+
+#include "../../../Empirical/config/config.h"
+#include "../../../Empirical/tools/vector.h"
+#include "../../../Empirical/tools/assert.h"
+
+EMP_BUILD_CONFIG(StatsConfig,
+  GROUP(DEFAULT, "Default settings group"),
+  VALUE(RESOLUTION, int, 10, "How often should stats be calculated (updates)"),
+  VALUE(DELIMITER, std::string, " ", "What should fields be separated by in the output")
+)
+
+constexpr int MAX_STATS_COLUMNS = 16;
+
+struct StatsRow {
+  int update;
+  int num_values;
+  double values[MAX_STATS_COLUMNS];
+};
+
+class StatsWriter {
+  private:
+    int resolution;
+    std::string delimiter;
+    std::ofstream file;
+    std::ostream *out;
+    int num_columns;
+    SPSCQueue<StatsRow> queue;
+    StatsRow row;                   // Row being filled in by the simulation thread.
+    emp::vector<StatsRow> overflow; // Rows that did not fit in the queue (simulation thread only)...
+    size_t overflow_head;           // ...starting from this one.
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;   // Flush/Close want the writer's attention.
+    std::condition_variable flushed;
+    uint64_t flush_requests;        // How many times the writer has been asked to flush...
+    uint64_t flushes_done;          // ...and how many of those the writer has carried out.
+    bool stopping;
+
+    void WriteRow(const StatsRow &r) {
+      *out << r.update;
+      for (int i = 0; i < r.num_values; i++) *out << delimiter << r.values[i];
+      *out << '\n';
+    }
+
+    // Move overflow rows into the queue, oldest first, while there is room.
+    void DrainOverflow() {
+      while (overflow_head < overflow.size() && queue.Push(overflow[overflow_head])) overflow_head++;
+      if (overflow_head == overflow.size()) {
+        overflow.resize(0);
+        overflow_head = 0;
+      }
+    }
+
+    // Wait until the writer has written out (and flushed) everything in the queue.
+    void WaitForWriter() {
+      std::unique_lock<std::mutex> lock(mutex);
+      const uint64_t request = ++flush_requests;
+      wake.notify_one();
+      flushed.wait(lock, [this, request]() { return flushes_done >= request; });
+    }
+
+    void RunWriter() {
+      StatsRow r;
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        // Rows pushed before a Flush/Close call are in the queue by the time we see the call.
+        const uint64_t requested = flush_requests;
+        const bool stop = stopping;
+        lock.unlock();
+        while (queue.Pop(r)) WriteRow(r);
+        if (requested > flushes_done || stop) out->flush();
+        lock.lock();
+        if (requested > flushes_done) {
+          flushes_done = requested;
+          flushed.notify_all();
+        }
+        if (stop) return;
+        // Nobody signals new rows (so Push stays lock free); look again every few ms.
+        wake.wait_for(lock, std::chrono::milliseconds(5), [this]() { return flush_requests > flushes_done || stopping; });
+      }
+    }
+
+  public:
+    // Write to filename ("" for standard output), starting with a header row of column names
+    // (the first column is always the update).
+    StatsWriter(const StatsConfig &config, const emp::vector<std::string> &columns,
+                const std::string &filename = "", int queue_rows = 1024)
+      : resolution(std::max(1, config.RESOLUTION())), delimiter(config.DELIMITER()), out(&std::cout),
+        num_columns((int) columns.size()), queue(queue_rows), overflow_head(0), writer(), flush_requests(0),
+        flushes_done(0), stopping(false)
+    {
+      emp_assert(num_columns <= MAX_STATS_COLUMNS);
+      if (delimiter == "") delimiter = " ";   // A blank DELIMITER in the cfg file is a space.
+      if (filename != "") {
+        file.open(filename);
+        if (!file) std::cerr << "Could not open " << filename << " for stats; writing them to standard output." << std::endl;
+        else out = &file;
+      }
+      *out << "update";
+      for (const auto &name : columns) *out << delimiter << name;
+      *out << '\n';
+      row.num_values = 0;
+      writer = std::thread(&StatsWriter::RunWriter, this);
+    }
+    StatsWriter(const StatsWriter &) = delete;
+    StatsWriter & operator=(const StatsWriter &) = delete;
+
+    ~StatsWriter() { Close(); }
+
+    int GetResolution() const { return resolution; }
+    bool IsSampleUpdate(int update) const { return update % resolution == 0; }
+    int GetNumOverflowed() const { return (int) (overflow.size() - overflow_head); }
+
+    // Fill in one row: Begin(update), then Add each column's value in order, then Push.
+    StatsWriter & Begin(int update) { row.update = update; row.num_values = 0; return *this; }
+    StatsWriter & Add(double value) {
+      emp_assert(row.num_values < num_columns);
+      row.values[row.num_values++] = value;
+      return *this;
+    }
+    void Push() {
+      emp_assert(row.num_values == num_columns);
+      DrainOverflow();
+      if (GetNumOverflowed() > 0 || !queue.Push(row)) overflow.push_back(row);
+    }
+
+    // Wait until every row pushed so far (overflow included) is written out.
+    void Flush() {
+      if (!writer.joinable()) return;
+      // Hand over the overflow a queue at a time.
+      do {
+        DrainOverflow();
+        WaitForWriter();
+      } while (GetNumOverflowed() > 0);
+    }
+
+    void Close() {
+      if (!writer.joinable()) return;
+      Flush();
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+      }
+      wake.notify_one();
+      writer.join();
+    }
+};
+
+#endif